@@ -0,0 +1,400 @@
+//
+// Benchmarks.cpp - Microbenchmarks for the simulation and render hot paths
+//
+// Run with --benchmark_format=json or --benchmark_out=<file> --benchmark_out_format=json to get machine-readable
+// results, and compare two result files with compare.py from Google Benchmark.
+//
+
+#include "Game.h"
+
+#include "GameBatch.h"
+
+#include "CourseAnalyzer.h"
+
+#include "SoftwareRenderer.h"
+
+#include "GradientGenerator.h"
+
+#include "RecordingRenderer.h"
+
+#include "RenderResourceCache.h"
+
+#include "Replay.h"
+
+#include "Policies.h"
+
+#include "StepTimer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	constexpr float WorldWidth = 12 * 16 / 9.0f, StepSeconds = 1 / 60.0f;
+
+	constexpr AutopilotPolicy Autopilot;
+
+	template <typename TGame>
+	void Update_NotStarted(benchmark::State& state) {
+		TGame game(WorldWidth);
+
+		for (auto _ : state) game.Update(StepSeconds);
+	}
+
+	template <typename TGame>
+	void Update_Running(benchmark::State& state) {
+		TGame game(WorldWidth, 0);
+		game.FlyUp();
+
+		for (auto _ : state) {
+			if (game.GetState() == TGame::State::Over) {
+				state.PauseTiming();
+				game.Reset();
+				game.FlyUp();
+				state.ResumeTiming();
+			}
+
+			if (Autopilot(game)) game.FlyUp();
+
+			game.Update(StepSeconds);
+		}
+	}
+
+	// One second of frames at range(0) Hz on a virtual clock, the autopilot playing and every frame drawn. The game
+	// steps once per frame when range(1) is 0, as a variable timestep does, and otherwise at range(1) Hz with frames
+	// blended between the last two ticks.
+	template <typename TGame>
+	void Frame_OneSecond(benchmark::State& state) {
+		const auto refreshRate = state.range(0), tickRate = state.range(1);
+
+		DX::BasicStepTimer<DX::VirtualClock> timer;
+		timer.SetFixedTimeStep(tickRate != 0);
+		if (tickRate) timer.SetTargetElapsedSeconds(1.0 / tickRate);
+
+		TGame game(WorldWidth, 0);
+
+		RecordingRenderer renderer({ WorldWidth * 100, 1200 });
+		RenderSnapshot snapshot, previousSnapshot, frameSnapshot;
+		SpriteBatch spriteBatch;
+		snapshot.Capture(game);
+		previousSnapshot = snapshot;
+
+		uint64_t tickCount = 0;
+		for (auto _ : state) {
+			for (int64_t frame = 0; frame < refreshRate; frame++) {
+				timer.GetClock().Advance(DX::VirtualClock::Frequency / refreshRate);
+				timer.Tick([&] {
+					if (game.GetState() != TGame::State::Running || Autopilot(game)) {
+						if (game.GetState() == TGame::State::Over) game.Reset();
+						else game.FlyUp();
+					}
+					game.Update(static_cast<float>(timer.GetElapsedSeconds()));
+
+					previousSnapshot = snapshot;
+					snapshot.Capture(game);
+
+					tickCount++;
+				});
+
+				frameSnapshot.Interpolate(previousSnapshot, snapshot, static_cast<float>(timer.GetInterpolationFactor()));
+				renderer.BeginFrame();
+				RenderGame(renderer, frameSnapshot, GetWorldTransform(renderer.GetSize(), frameSnapshot.WorldSize), spriteBatch);
+				renderer.EndFrame();
+			}
+		}
+
+		state.counters["Ticks"] = static_cast<double>(tickCount) / state.iterations();
+	}
+
+	// Restores a warm game to one of two ticks of the autopilot's play in turn and snapshots it again, as a search that
+	// branches from saved states does.
+	template <typename TGame>
+	void Snapshot_Restore(benchmark::State& state) {
+		const auto trace = RecordTrace<TGame>(Autopilot, 60 * 20);
+
+		TGame game(trace.WorldWidth, trace.Seed);
+		typename TGame::SavedState savedStates[2], snapshot;
+		for (uint32_t tick = 0; tick < trace.Presses.size(); tick++) {
+			if (trace.Presses[tick]) {
+				if (game.GetState() == TGame::State::Over) game.Reset();
+				else game.FlyUp();
+			}
+			game.Update(trace.StepSeconds);
+
+			if (tick == 60 * 10) game.Snapshot(savedStates[0]);
+		}
+		game.Snapshot(savedStates[1]);
+
+		size_t i = 0;
+		for (auto _ : state) {
+			game.Restore(savedStates[i++ & 1]);
+			game.Snapshot(snapshot);
+			benchmark::DoNotOptimize(snapshot);
+		}
+
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Seeks to random ticks of a ten-minute replay held in memory, as a mapped file would be once its pages are cached.
+	template <typename TGame>
+	void Replay_Seek(benchmark::State& state) {
+		ostringstream stream;
+		WriteReplay<TGame>(stream, RecordTrace<TGame>(Autopilot, 60 * 60 * 10), static_cast<uint32_t>(state.range(0)));
+		const auto bytes = stream.str();
+
+		const ReplayReader reader(as_bytes(span(bytes)));
+		TGame game(WorldWidth);
+		mt19937 random(0);
+		for (auto _ : state) reader.Seek(game, random() % (reader.GetHeader().TickCount + 1));
+
+		state.counters["BytesPerTick"] = static_cast<double>(bytes.size()) / reader.GetHeader().TickCount;
+	}
+
+	template <typename TPhysics>
+	void AddBarrier_RemoveFrontBarrier(benchmark::State& state) {
+		TPhysics physics;
+		for (auto i = 0; i < 4; i++) physics.AddBarrier(i * 5.0f, 0.85f, 2, 1.4f, 2.6f);
+
+		auto positionX = 20.0f;
+		for (auto _ : state) {
+			physics.AddBarrier(positionX += 5, 0.85f, 2, 1.4f, 2.6f);
+			physics.RemoveFrontBarrier();
+		}
+
+		// Stays at the initial barrier count plus one however many iterations run.
+		if constexpr (requires { physics.GetCreatedBodyCount(); }) {
+			state.counters["BodiesCreated"] = static_cast<double>(physics.GetCreatedBodyCount());
+		}
+	}
+
+	// Restarts an episode that has its barriers, as bulk evaluation does between games.
+	template <typename TGame>
+	void Reset(benchmark::State& state) {
+		TGame game(WorldWidth);
+
+		for (auto _ : state) {
+			game.FlyUp();
+			game.Reset();
+		}
+	}
+
+	void ShiftOrigin(benchmark::State& state) {
+		Box2DPhysics physics;
+		physics.CreateGround({ WorldWidth / 2, -0.1f }, { 50, 0.1f });
+		physics.CreatePawn({ WorldWidth / 2, 6 }, { 2, 0 }, 0.5f);
+		for (int64_t i = 0; i < state.range(0); i++) physics.AddBarrier(i * 5.0f, 0.85f, 2, 1.4f, 2.6f);
+
+		auto offset = 0.05f;
+		for (auto _ : state) physics.ShiftOrigin({ offset = -offset, 0 });
+
+		state.SetComplexityN(state.range(0));
+	}
+
+	// The per-frame walk RenderWorld does over bodies and fixtures, stopping where it would issue draws.
+	template <typename TGame>
+	void ForEachSprite(benchmark::State& state) {
+		TGame game(WorldWidth);
+		game.FlyUp();
+
+		for (auto _ : state) {
+			game.GetPhysics().ForEachSprite([](const Sprite& sprite) {
+				auto width = sprite.Right - sprite.Left, height = sprite.Bottom - sprite.Top;
+				benchmark::DoNotOptimize(width);
+				benchmark::DoNotOptimize(height);
+			});
+		}
+	}
+
+	void GameBatch_Step(benchmark::State& state) {
+		const auto count = static_cast<size_t>(state.range(0));
+
+		GameBatch batch(count, 0, WorldWidth);
+		vector<uint8_t> actions(count, 1);
+		batch.Step(actions.data(), StepSeconds);
+
+		uint32_t tick = 0;
+		for (auto _ : state) {
+			if (++tick % 40 == 1) fill(actions.begin(), actions.end(), 1);
+			batch.Step(actions.data(), StepSeconds);
+			if (tick % 40 == 1) fill(actions.begin(), actions.end(), 0);
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+		state.counters["BytesPerGame"] = static_cast<double>(GameBatch::GameSize);
+	}
+
+	// Courses of 50 barriers screened per second, as items.
+	void CourseAnalyzer_Analyze(benchmark::State& state) {
+		const auto count = static_cast<size_t>(state.range(0));
+
+		const CourseAnalyzer analyzer;
+		vector<float> margins(count);
+
+		uint32_t firstSeed = 0;
+		for (auto _ : state) {
+			analyzer.Analyze(firstSeed, count, 50, margins.data());
+			benchmark::DoNotOptimize(margins.data());
+			firstSeed += static_cast<uint32_t>(count);
+		}
+
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	// Whole frames of a game that is over, so the score, every text line, the pawn and all barriers are drawn.
+	void SoftwareRenderer_RenderGame(benchmark::State& state) {
+		const auto width = static_cast<uint32_t>(state.range(0)), height = static_cast<uint32_t>(state.range(1));
+
+		AnalyticGame game(12.0f * width / height, 0);
+		game.FlyUp();
+		while (game.GetState() != AnalyticGame::State::Over) game.Update(StepSeconds);
+
+		RenderSnapshot snapshot;
+		snapshot.Capture(game);
+
+		SoftwareRenderer renderer(width, height);
+		const auto transform = GetWorldTransform(renderer.GetSize(), snapshot.WorldSize);
+		SpriteBatch spriteBatch;
+
+		for (auto _ : state) {
+			renderer.BeginFrame();
+			RenderGame(renderer, snapshot, transform, spriteBatch);
+			renderer.EndFrame();
+			benchmark::DoNotOptimize(renderer.GetPixels());
+		}
+
+		state.counters["FramesPerSecond"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	}
+
+	// Capture and submission of a running game as the world widens. DrawCalls stays the same however many barriers
+	// are visible; Sprites grows with them.
+	void SpriteBatch_RenderGame(benchmark::State& state) {
+		const auto worldWidth = static_cast<float>(state.range(0));
+
+		AnalyticGame game(worldWidth, 0);
+		game.FlyUp();
+		for (uint32_t i = 0; i < 600; i++) {
+			if (Autopilot(game)) game.FlyUp();
+			game.Update(StepSeconds);
+		}
+
+		RecordingRenderer renderer({ worldWidth * 100, 1200 });
+		RenderSnapshot snapshot;
+		SpriteBatch spriteBatch;
+
+		for (auto _ : state) {
+			snapshot.Capture(game);
+			renderer.BeginFrame();
+			RenderGame(renderer, snapshot, GetWorldTransform(renderer.GetSize(), snapshot.WorldSize), spriteBatch);
+			renderer.EndFrame();
+		}
+
+		state.counters["DrawCalls"] = renderer.GetFrameCounts().DrawCalls;
+		state.counters["Sprites"] = renderer.GetFrameCounts().Sprites;
+	}
+
+	// What the Direct2D renderer bakes for a window of that size: the background, and the pawn ellipse at a tenth.
+	void GradientGenerator_Generate(benchmark::State& state) {
+		const auto width = static_cast<uint32_t>(state.range(0)), height = static_cast<uint32_t>(state.range(1));
+		const auto isEllipse = state.range(2) != 0;
+
+		const auto stride = (width + Simd::Width - 1) / Simd::Width * Simd::Width;
+		vector<uint32_t> pixels(stride * height);
+
+		for (auto _ : state) {
+			GenerateGradient(GetGradient(isEllipse ? Brush::Pawn : Brush::Background), width, height, isEllipse, true, pixels.data(), stride);
+			benchmark::DoNotOptimize(pixels.data());
+		}
+
+		state.SetItemsProcessed(state.iterations() * width * height);
+	}
+
+	// What logging costs the simulation thread per event, with the queue drained as often as a writer would need to.
+	void GameEventQueue_Push(benchmark::State& state) {
+		GameEventQueue queue;
+
+		uint32_t tick = 0;
+		for (auto _ : state) {
+			queue.Push({ tick, GameEventType::Flap, 0, 0, 1, 2 });
+
+			if (++tick % GameEventQueue::Capacity == 0) {
+				for (GameEvent event; queue.TryPop(event);) benchmark::DoNotOptimize(event);
+			}
+		}
+
+		state.counters["Dropped"] = static_cast<double>(queue.GetDroppedCount());
+	}
+
+	// Stands in for Direct2D and DirectWrite and counts what the cache asks it to create.
+	struct CountingResources {
+		using TextFormat = uint32_t;
+		using SolidBrush = uint32_t;
+		using TextLayout = uint32_t;
+
+		uint32_t CreatedCount{};
+
+		TextFormat CreateTextFormat(string_view, float) { return ++CreatedCount; }
+		SolidBrush CreateSolidBrush(uint32_t) { return ++CreatedCount; }
+		TextLayout CreateTextLayout(string_view, const TextFormat&, float, float) { return ++CreatedCount; }
+	};
+
+	// The text RenderGame draws for a game that is over, which hits the cache for every lookup after the first frame.
+	void RenderResourceCache_Frame(benchmark::State& state) {
+		RenderResourceCache<CountingResources> cache;
+
+		const auto RenderFrame = [&] {
+			constexpr auto FontFamily = "Comic Sans MS";
+			constexpr float Height = 720;
+			const auto RenderText = [&](string_view text, float fontSize, uint32_t rgb) {
+				benchmark::DoNotOptimize(cache.GetTextLayout(text, FontFamily, fontSize * Height, Height * 16 / 9, fontSize * Height));
+				benchmark::DoNotOptimize(cache.GetSolidBrush(rgb));
+			};
+			RenderText("42", 0.08f, 0x0063b1);
+			RenderText("Game Over", 0.1f, 0xea005e);
+			RenderText("Press any key to restart.", 0.04f, 0x008080);
+			cache.EndFrame();
+		};
+
+		RenderFrame();
+		const auto createdCount = cache.GetBackend().CreatedCount;
+
+		for (auto _ : state) RenderFrame();
+
+		const auto& statistics = cache.GetStatistics();
+		state.counters["Hits"] = static_cast<double>(statistics.Hits);
+		state.counters["Misses"] = static_cast<double>(statistics.Misses);
+		state.counters["Evictions"] = static_cast<double>(statistics.Evictions);
+		state.counters["CreatedAfterFirstFrame"] = static_cast<double>(cache.GetBackend().CreatedCount - createdCount);
+	}
+}
+
+BENCHMARK(Update_NotStarted<Game>);
+BENCHMARK(Update_NotStarted<AnalyticGame>);
+BENCHMARK(Update_Running<Game>);
+BENCHMARK(Update_Running<AnalyticGame>);
+BENCHMARK(Frame_OneSecond<Game>)->ArgsProduct({ { 60, 144, 240 }, { 0, 30, 60 } });
+BENCHMARK(Frame_OneSecond<AnalyticGame>)->ArgsProduct({ { 60, 144, 240 }, { 0, 30, 60 } });
+BENCHMARK(Snapshot_Restore<Game>);
+BENCHMARK(Snapshot_Restore<AnalyticGame>);
+BENCHMARK(Replay_Seek<Game>)->Arg(15)->Arg(60);
+BENCHMARK(Replay_Seek<AnalyticGame>)->Arg(15)->Arg(60);
+BENCHMARK(AddBarrier_RemoveFrontBarrier<Box2DPhysics>);
+BENCHMARK(AddBarrier_RemoveFrontBarrier<AnalyticPhysics>);
+BENCHMARK(Reset<Game>);
+BENCHMARK(Reset<AnalyticGame>);
+BENCHMARK(ShiftOrigin)->RangeMultiplier(2)->Range(4, Box2DPhysics::MaxBarrierCount)->Complexity();
+BENCHMARK(ForEachSprite<Game>);
+BENCHMARK(ForEachSprite<AnalyticGame>);
+BENCHMARK(GameBatch_Step)->Arg(1024)->Arg(100000);
+BENCHMARK(CourseAnalyzer_Analyze)->Arg(4096);
+BENCHMARK(GameEventQueue_Push);
+BENCHMARK(RenderResourceCache_Frame);
+BENCHMARK(SpriteBatch_RenderGame)->Arg(16)->Arg(32)->Arg(64);
+BENCHMARK(GradientGenerator_Generate)->Args({ 1920, 1080, 0 })->Args({ 192, 108, 1 });
+BENCHMARK(SoftwareRenderer_RenderGame)->Args({ 84, 84 })->Args({ 640, 360 })->Args({ 1280, 720 })->Args({ 1920, 1080 });
+
+BENCHMARK_MAIN();
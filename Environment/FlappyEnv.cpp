@@ -0,0 +1,72 @@
+#include "FlappyEnv.h"
+
+#include "GameBatch.h"
+
+struct flappy_env {
+	static constexpr float StepSeconds = 1 / 60.0f;
+
+	GameBatch Batch;
+
+	std::vector<uint32_t> Scores;
+
+	flappy_env(uint32_t count, uint32_t seed) : Batch(count, seed), Scores(count) {}
+
+	void Observe(size_t index, float* observation) const noexcept {
+		using Rules = GameBatch::Rules;
+
+		const auto pawnPosition = Batch.GetPawnPosition(index);
+
+		int32_t barrier = 0;
+		while (barrier + 1 < Batch.GetBarrierCount() && Batch.GetBarrierPositionX(index, barrier) + Rules::BarrierWidth / 2 < pawnPosition.x - Rules::PawnRadius) barrier++;
+
+		observation[0] = pawnPosition.y;
+		observation[1] = Batch.GetPawnVelocityY(index);
+		observation[2] = Batch.GetBarrierPositionX(index, barrier) - pawnPosition.x;
+		const auto hasBarriers = Batch.GetState(index) != GameBatch::State::NotStarted;
+		observation[3] = hasBarriers ? Batch.GetBarrierGapBottom(index, barrier) : 0;
+		observation[4] = hasBarriers ? Batch.GetBarrierGapTop(index, barrier) : 0;
+	}
+
+	void Reset(size_t index) noexcept {
+		Batch.Reset(index);
+		Scores[index] = 0;
+	}
+};
+
+flappy_env* flappy_env_create(uint32_t count, uint32_t seed) {
+	try { return new flappy_env(count, seed); }
+	catch (...) { return nullptr; }
+}
+
+void flappy_env_destroy(flappy_env* env) { delete env; }
+
+uint32_t flappy_env_get_count(const flappy_env* env) { return static_cast<uint32_t>(env->Batch.GetCount()); }
+
+void flappy_env_observe(const flappy_env* env, float* observations) {
+	for (size_t i = 0; i < env->Batch.GetCount(); i++) env->Observe(i, observations + i * FLAPPY_ENV_OBSERVATION_SIZE);
+}
+
+void flappy_env_step(flappy_env* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones) {
+	env->Batch.Step(actions, flappy_env::StepSeconds);
+
+	for (size_t i = 0; i < env->Batch.GetCount(); i++) {
+		const auto isOver = env->Batch.GetState(i) == GameBatch::State::Over;
+
+		const auto score = env->Batch.GetScore(i);
+		rewards[i] = isOver ? -1.0f : static_cast<float>(score - env->Scores[i]);
+		env->Scores[i] = score;
+
+		dones[i] = isOver;
+		if (isOver) env->Reset(i);
+
+		env->Observe(i, observations + i * FLAPPY_ENV_OBSERVATION_SIZE);
+	}
+}
+
+void flappy_env_reset_mask(flappy_env* env, const uint8_t* mask, float* observations) {
+	for (size_t i = 0; i < env->Batch.GetCount(); i++) {
+		if (mask[i]) env->Reset(i);
+	}
+
+	flappy_env_observe(env, observations);
+}
@@ -0,0 +1,60 @@
+/*
+ * C ABI for stepping many headless games at once from another language or process, e.g. through ctypes or cffi.
+ *
+ * Every call writes into arrays the caller owns, which may live in shared memory; nothing is allocated or copied
+ * after flappy_env_create. Arrays hold one entry per game, and observations FLAPPY_ENV_OBSERVATION_SIZE floats per
+ * game, in world units with y up:
+ *   0: pawn height
+ *   1: pawn vertical velocity
+ *   2: horizontal distance from the pawn to the center of the next barrier it has not passed
+ *   3: bottom of that barrier's gap
+ *   4: top of that barrier's gap
+ *
+ * A game starts bobbing in place and begins scrolling with its first fly-up action. Until then it has no barriers, and
+ * entries 3 and 4 are 0.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if defined(_WIN32)
+#ifdef FLAPPY_ENV_EXPORTS
+#define FLAPPY_ENV_API __declspec(dllexport)
+#else
+#define FLAPPY_ENV_API __declspec(dllimport)
+#endif
+#else
+#define FLAPPY_ENV_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLAPPY_ENV_OBSERVATION_SIZE 5
+
+typedef struct flappy_env flappy_env;
+
+/* Game i draws the same course as a game seeded with seed + i. Returns NULL on failure. */
+FLAPPY_ENV_API flappy_env* flappy_env_create(uint32_t count, uint32_t seed);
+
+FLAPPY_ENV_API void flappy_env_destroy(flappy_env* env);
+
+FLAPPY_ENV_API uint32_t flappy_env_get_count(const flappy_env* env);
+
+/* Writes the current observation of every game. */
+FLAPPY_ENV_API void flappy_env_observe(const flappy_env* env, float* observations);
+
+/*
+ * Advances every game by 1/60 s, flying up first where actions[i] is non-zero. rewards[i] is the number of gaps
+ * cleared during the step, or -1 if the game ended. A game that ended sets dones[i] to 1 and is reset within the
+ * same call, so its observation is already the first of the next episode.
+ */
+FLAPPY_ENV_API void flappy_env_step(flappy_env* env, const uint8_t* actions, float* observations, float* rewards, uint8_t* dones);
+
+/* Resets the games where mask[i] is non-zero and writes every observation. */
+FLAPPY_ENV_API void flappy_env_reset_mask(flappy_env* env, const uint8_t* mask, float* observations);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Determinism.h"
+
+#include "AllocationTracker.h"
+
+struct AllocatingTick {
+	uint32_t Tick;
+	AllocationTracker::Counts Counts;
+};
+
+// Replays a trace like SimulateTrace and returns the first tick from warmupTicks on that started with the game
+// Running and allocated on this thread, press included. Nothing is counted unless FLAPPY_BIRD_TRACK_ALLOCATIONS is
+// defined, and Box2D's own allocations only when it is built with b2_user_settings.h.
+template <typename TGame = Game>
+std::optional<AllocatingTick> FindSteadyStateAllocation(const InputTrace& trace, uint32_t warmupTicks) {
+	TGame game(trace.WorldWidth, trace.Seed);
+
+	for (uint32_t tick = 0; tick < trace.Presses.size(); tick++) {
+		const auto isRunning = game.GetState() == TGame::State::Running;
+		const auto counts = AllocationTracker::GetThreadCounts();
+
+		if (trace.Presses[tick]) {
+			if (game.GetState() == TGame::State::Over) game.Reset();
+			else game.FlyUp();
+		}
+
+		game.Update(trace.StepSeconds);
+
+		if (const auto tickCounts = AllocationTracker::GetThreadCounts() - counts; isRunning && tick >= warmupTicks && tickCounts.Allocations) {
+			return AllocatingTick{ tick, tickCounts };
+		}
+	}
+
+	return std::nullopt;
+}
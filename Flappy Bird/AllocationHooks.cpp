@@ -0,0 +1,60 @@
+// Replaces the global allocation functions so that AllocationTracker sees every C++ heap allocation. The array and
+// nothrow forms forward to these by default. Compiles to nothing unless FLAPPY_BIRD_TRACK_ALLOCATIONS is defined.
+#ifdef FLAPPY_BIRD_TRACK_ALLOCATIONS
+
+#include "AllocationTracker.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+	void* AllocateAligned(size_t size, size_t alignment) noexcept {
+#ifdef _MSC_VER
+		return _aligned_malloc(size, alignment);
+#else
+		return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+	}
+
+	void FreeAligned(void* p) noexcept {
+#ifdef _MSC_VER
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+}
+
+void* operator new(size_t size) {
+	AllocationTracker::RecordAllocation(size);
+
+	if (const auto p = std::malloc(size ? size : 1)) return p;
+	throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+	AllocationTracker::RecordAllocation(size);
+
+	if (const auto p = AllocateAligned(size ? size : 1, static_cast<size_t>(alignment))) return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+	if (p == nullptr) return;
+
+	AllocationTracker::RecordFree();
+	std::free(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+	if (p == nullptr) return;
+
+	AllocationTracker::RecordFree();
+	FreeAligned(p);
+}
+
+void operator delete(void* p, size_t) noexcept { ::operator delete(p); }
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept { ::operator delete(p, alignment); }
+
+#endif
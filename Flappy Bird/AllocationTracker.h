@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <vector>
+
+// Counts heap allocations by the innermost phase open on the allocating thread. AllocationHooks.cpp routes the global
+// operator new and delete here when FLAPPY_BIRD_TRACK_ALLOCATIONS is defined, and b2_user_settings.h does the same for
+// Box2D's b2Alloc and b2Free when Box2D is built with BOX2D_USER_SETTINGS. Every TRACE_ZONE opens a phase.
+//
+// Recording neither allocates nor locks, so the hooks can call it from anywhere. Box2D includes this header while it
+// builds, so it depends on nothing else in the game.
+namespace AllocationTracker {
+	struct Counts {
+		uint64_t Allocations, Bytes, Frees;
+
+		friend Counts operator-(const Counts& a, const Counts& b) noexcept { return { a.Allocations - b.Allocations, a.Bytes - b.Bytes, a.Frees - b.Frees }; }
+	};
+
+	struct PhaseCounts {
+		const char* Name;
+		AllocationTracker::Counts Counts;
+	};
+
+	// Phases are told apart by name, as zone names are string literals that different translation units may not
+	// share. Allocations outside any phase, or past Capacity phases, go to the first slot.
+	class Table {
+	public:
+		static constexpr size_t Capacity = 64;
+
+		static Table& Get() noexcept {
+			static Table table;
+			return table;
+		}
+
+		void Record(const char* phase, uint64_t allocations, uint64_t bytes, uint64_t frees) noexcept {
+			auto& slot = m_slots[Find(phase)];
+			if (allocations) slot.Allocations.fetch_add(allocations, std::memory_order_relaxed);
+			if (bytes) slot.Bytes.fetch_add(bytes, std::memory_order_relaxed);
+			if (frees) slot.Frees.fetch_add(frees, std::memory_order_relaxed);
+		}
+
+		std::vector<PhaseCounts> GetPhaseCounts() const {
+			std::vector<PhaseCounts> phaseCounts;
+			for (const auto& slot : m_slots) {
+				const auto name = slot.Name.load(std::memory_order_acquire);
+				if (name == nullptr) break;
+
+				phaseCounts.push_back({ name, { slot.Allocations.load(std::memory_order_relaxed), slot.Bytes.load(std::memory_order_relaxed), slot.Frees.load(std::memory_order_relaxed) } });
+			}
+			return phaseCounts;
+		}
+
+	private:
+		struct Slot {
+			std::atomic<const char*> Name;
+			std::atomic<uint64_t> Allocations, Bytes, Frees;
+		};
+		Slot m_slots[Capacity]{};
+
+		Table() noexcept { m_slots[0].Name = "Unattributed"; }
+
+		size_t Find(const char* phase) noexcept {
+			if (phase == nullptr) return 0;
+
+			for (size_t i = 1; i < Capacity; i++) {
+				auto name = m_slots[i].Name.load(std::memory_order_acquire);
+				if (name == nullptr && m_slots[i].Name.compare_exchange_strong(name, phase, std::memory_order_acq_rel)) return i;
+				if (name == phase || std::strcmp(name, phase) == 0) return i;
+			}
+			return 0;
+		}
+	};
+
+	inline thread_local const char* t_phase;
+
+	inline thread_local Counts t_counts;
+
+	inline void RecordAllocation(size_t bytes) noexcept {
+		t_counts.Allocations++;
+		t_counts.Bytes += bytes;
+		Table::Get().Record(t_phase, 1, bytes, 0);
+	}
+
+	inline void RecordFree() noexcept {
+		t_counts.Frees++;
+		Table::Get().Record(t_phase, 0, 0, 1);
+	}
+
+	// Everything the calling thread has allocated and freed, for measuring a span of work on one thread.
+	inline Counts GetThreadCounts() noexcept { return t_counts; }
+
+	inline std::vector<PhaseCounts> GetPhaseCounts() { return Table::Get().GetPhaseCounts(); }
+
+	class Phase {
+	public:
+		explicit Phase(const char* name) noexcept : m_previous(t_phase) { t_phase = name; }
+
+		~Phase() { t_phase = m_previous; }
+
+		Phase(const Phase&) = delete;
+		Phase& operator=(const Phase&) = delete;
+
+	private:
+		const char* const m_previous;
+	};
+
+	// Allocations, bytes and frees per tick of each phase that has allocated, over tickCount ticks.
+	inline void WriteReport(std::ostream& stream, uint64_t tickCount) {
+		const auto ticks = static_cast<double>(tickCount ? tickCount : 1);
+		for (const auto& [name, counts] : GetPhaseCounts()) {
+			if (!counts.Allocations && !counts.Frees) continue;
+
+			stream << name << ": " << counts.Allocations / ticks << " allocations, " << counts.Bytes / ticks << " bytes, " << counts.Frees / ticks << " frees per tick\n";
+		}
+	}
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "Box2DPhysics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+// Closed-form replacement for Box2DPhysics specialized to this game: one circle against static axis-aligned boxes.
+// Integration matches Box2D's semi-implicit Euler and contacts use the same polygon skin, so deaths, gap sensor
+// scoring and ground contact happen on the same steps without a broadphase, heap allocations or virtual calls.
+struct AnalyticPhysics {
+	static constexpr size_t MaxBarrierCount = 16;
+
+	// The whole state is plain data, so a snapshot is simply a copy.
+	using SavedState = AnalyticPhysics;
+
+	// Box2D keeps polygons b2_polygonRadius apart; a circle touches a box as soon as it is within this distance.
+	static constexpr float ContactSkin = 0.01f;
+
+	void Clear() {
+		m_gravity = {};
+		m_groundTop = {};
+		m_pawn = {};
+		m_barrierFront = m_barrierCount = 0;
+	}
+
+	void Save(SavedState& state) const noexcept { state = *this; }
+
+	void Restore(const SavedState& state) noexcept { *this = state; }
+
+	// Whether state keeps the barrier ring's invariants, for states read from outside the process.
+	static bool CanRestore(const SavedState& state) noexcept { return state.m_barrierFront < MaxBarrierCount && state.m_barrierCount <= MaxBarrierCount; }
+
+	b2Vec2 GetGravity() const noexcept { return m_gravity; }
+	void SetGravity(b2Vec2 value) noexcept { m_gravity = value; }
+
+	void CreateGround(b2Vec2 position, b2Vec2 halfSize) noexcept { m_groundTop = position.y + halfSize.y; }
+
+	void MoveGround(float) noexcept {}
+
+	void CreatePawn(b2Vec2 position, b2Vec2 linearVelocity, float radius) noexcept {
+		m_pawn = { .Position = position, .LinearVelocity = linearVelocity, .Radius = radius };
+	}
+
+	b2Vec2 GetPawnPosition() const noexcept { return m_pawn.Position; }
+
+	float GetPawnAngle() const noexcept { return m_pawn.Angle; }
+
+	float GetPawnAngularVelocity() const noexcept { return m_pawn.AngularVelocity; }
+
+	b2Vec2 GetPawnLinearVelocity() const noexcept { return m_pawn.LinearVelocity; }
+	void SetPawnLinearVelocity(b2Vec2 value) noexcept { m_pawn.LinearVelocity = value; }
+
+	void AddBarrier(float positionX, float halfWidth, float bottomHalfHeight, float gapHalfHeight, float topHalfHeight) {
+		if (m_barrierCount == MaxBarrierCount) throw std::length_error("Too many barriers");
+
+		const auto gapBottom = bottomHalfHeight * 2, gapTop = gapBottom + gapHalfHeight * 2;
+		m_barriers[(m_barrierFront + m_barrierCount++) % MaxBarrierCount] = {
+			.PositionX = positionX,
+			.HalfWidth = halfWidth,
+			.GapBottom = gapBottom,
+			.GapTop = gapTop,
+			.Top = gapTop + topHalfHeight * 2
+		};
+	}
+
+	void RemoveFrontBarrier() noexcept {
+		m_barrierFront = (m_barrierFront + 1) % MaxBarrierCount;
+		m_barrierCount--;
+	}
+
+	size_t GetBarrierCount() const noexcept { return m_barrierCount; }
+
+	float GetBarrierPositionX(size_t index) const noexcept { return m_barriers[(m_barrierFront + index) % MaxBarrierCount].PositionX; }
+
+	PhysicsBarrier GetBarrier(size_t index) const noexcept {
+		const auto& barrier = m_barriers[(m_barrierFront + index) % MaxBarrierCount];
+		return { barrier.PositionX, barrier.HalfWidth, barrier.GapBottom, barrier.GapTop, barrier.Top };
+	}
+
+	// Same sprites in the same order as Box2DPhysics: the pawn, then every barrier bottom to top.
+	template <typename TCallback>
+	void ForEachSprite(TCallback&& callback) const {
+		const auto& [position, linearVelocity, angle, angularVelocity, radius, isTouching] = m_pawn;
+		callback(Sprite{ ObjectType::Pawn, true, position.x - radius, position.y + radius, position.x + radius, position.y - radius, angle });
+
+		for (size_t i = 0; i < m_barrierCount; i++) {
+			const auto& barrier = m_barriers[(m_barrierFront + i) % MaxBarrierCount];
+			const auto left = barrier.PositionX - barrier.HalfWidth, right = barrier.PositionX + barrier.HalfWidth;
+			callback(Sprite{ ObjectType::BarrierBottom, false, left, barrier.GapBottom, right, 0, 0 });
+			callback(Sprite{ ObjectType::BarrierTop, false, left, barrier.Top, right, barrier.GapTop, 0 });
+		}
+	}
+
+	PhysicsContacts Step(float elapsedSeconds) noexcept {
+		TRACE_ZONE("Physics.Step");
+
+		auto& [position, linearVelocity, angle, angularVelocity, radius, wasTouching] = m_pawn;
+
+		linearVelocity += { m_gravity.x * elapsedSeconds, m_gravity.y * elapsedSeconds };
+		position += { linearVelocity.x * elapsedSeconds, linearVelocity.y * elapsedSeconds };
+		angle += angularVelocity * elapsedSeconds;
+
+		const auto reach = radius + ContactSkin;
+
+		const auto GetClosestDelta = [&](float left, float bottom, float right, float top) {
+			return position - b2Vec2{ std::clamp(position.x, left, right), std::clamp(position.y, bottom, top) };
+		};
+
+		const auto Overlaps = [&](float left, float bottom, float right, float top) {
+			const auto delta = GetClosestDelta(left, bottom, right, top);
+			return delta.x * delta.x + delta.y * delta.y < reach * reach;
+		};
+
+		// Pushes the pawn out of a solid box along the contact normal and drops its velocity into the box, as an inelastic contact would.
+		const auto Collide = [&](float left, float bottom, float right, float top) {
+			const auto delta = GetClosestDelta(left, bottom, right, top);
+			const auto distanceSquared = delta.x * delta.x + delta.y * delta.y;
+			if (distanceSquared >= reach * reach) return false;
+
+			b2Vec2 normal;
+			auto depth = reach;
+			if (distanceSquared > 0) {
+				const auto distance = std::sqrt(distanceSquared);
+				normal = { delta.x / distance, delta.y / distance };
+				depth -= distance;
+			}
+			else if (const auto penetrationX = std::min(position.x - left, right - position.x), penetrationY = std::min(position.y - bottom, top - position.y); penetrationX < penetrationY) {
+				normal = { position.x - left < right - position.x ? -1.0f : 1.0f, 0 };
+				depth += penetrationX;
+			}
+			else {
+				normal = { 0, position.y - bottom < top - position.y ? -1.0f : 1.0f };
+				depth += penetrationY;
+			}
+
+			position += { normal.x * depth, normal.y * depth };
+			if (const auto normalVelocity = linearVelocity.x * normal.x + linearVelocity.y * normal.y; normalVelocity < 0) {
+				linearVelocity -= { normal.x * normalVelocity, normal.y * normalVelocity };
+			}
+			return true;
+		};
+
+		bool isTouching = false;
+		uint32_t gapsLeft = 0;
+
+		for (size_t i = 0; i < m_barrierCount; i++) {
+			auto& barrier = GetBarrierState(i);
+
+			const auto left = barrier.PositionX - barrier.HalfWidth, right = barrier.PositionX + barrier.HalfWidth;
+			if (position.x + reach > left && position.x - reach < right) {
+				isTouching |= Collide(left, 0, right, barrier.GapBottom);
+				isTouching |= Collide(left, barrier.GapTop, right, barrier.Top);
+			}
+
+			const auto isPawnInGap = Overlaps(left, barrier.GapBottom, right, barrier.GapTop);
+			if (barrier.IsPawnInGap && !isPawnInGap) gapsLeft++;
+			barrier.IsPawnInGap = isPawnInGap;
+		}
+
+		if (position.y - reach < m_groundTop) {
+			position.y = m_groundTop + reach;
+			if (linearVelocity.y < 0) linearVelocity.y = 0;
+			angularVelocity = -linearVelocity.x / radius;
+			isTouching = true;
+		}
+
+		const PhysicsContacts contacts{ .IsHit = isTouching && !wasTouching, .GapsCleared = isTouching && !wasTouching ? 0 : gapsLeft };
+		wasTouching = isTouching;
+		return contacts;
+	}
+
+	void ShiftOrigin(b2Vec2 newOrigin) noexcept {
+		TRACE_ZONE("Physics.ShiftOrigin");
+
+		m_pawn.Position -= newOrigin;
+
+		for (size_t i = 0; i < m_barrierCount; i++) GetBarrierState(i).PositionX -= newOrigin.x;
+	}
+
+private:
+	struct Barrier {
+		float PositionX, HalfWidth;
+		float GapBottom, GapTop, Top;
+		bool IsPawnInGap{};
+	};
+
+	b2Vec2 m_gravity{};
+
+	float m_groundTop{};
+
+	struct Pawn {
+		b2Vec2 Position, LinearVelocity;
+		float Angle{}, AngularVelocity{}, Radius;
+		bool IsTouching{};
+	} m_pawn{};
+
+	std::array<Barrier, MaxBarrierCount> m_barriers{};
+	size_t m_barrierFront{}, m_barrierCount{};
+
+	Barrier& GetBarrierState(size_t index) noexcept { return m_barriers[(m_barrierFront + index) % MaxBarrierCount]; }
+};
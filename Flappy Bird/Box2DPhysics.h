@@ -0,0 +1,390 @@
+#pragma once
+
+#include "box2d/box2d.h"
+
+#include "Trace.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+enum class ObjectType { Unknown, Pawn, BarrierTop, BarrierBottom };
+
+// What the renderer draws for one solid shape: an axis-aligned rectangle in world units, y up, rotated by Angle about
+// its center. Pawns are drawn as the ellipse inscribed in it.
+struct Sprite {
+	::ObjectType ObjectType;
+	bool IsEllipse;
+	float Left, Top, Right, Bottom;
+	float Angle;
+};
+
+struct PhysicsContacts {
+	bool IsHit;
+	uint32_t GapsCleared;
+};
+
+// A barrier spans [PositionX - HalfWidth, PositionX + HalfWidth] and is solid on [0, GapBottom] and [GapTop, Top].
+struct PhysicsBarrier {
+	float PositionX, HalfWidth;
+	float GapBottom, GapTop, Top;
+};
+
+struct Box2DPhysics : b2ContactListener {
+	static constexpr size_t MaxBarrierCount = 32;
+
+	// Bodies are not saved, only where they are and how they move, and which gap sensors the pawn was touching as of
+	// the last Step. Restoring repositions the existing bodies and reshapes barrier fixtures in place, creating or
+	// destroying barrier bodies only when the counts differ. It drops the pawn's contacts, which Box2D finds again on
+	// the next Step, and that Step scores the gaps PawnInGapMask says the pawn has since left instead of the sensor
+	// events, so a restored Running game plays on exactly as the saved one did. Contact impulses are not saved, so an
+	// Over game resting on the ground may settle differently.
+	struct SavedState {
+		b2Vec2 Gravity;
+		float GroundPositionX;
+		b2Vec2 PawnPosition, PawnLinearVelocity;
+		float PawnAngle, PawnAngularVelocity;
+		uint32_t BarrierCount, PawnInGapMask;
+		std::array<PhysicsBarrier, MaxBarrierCount> Barriers;
+	};
+
+	static_assert(MaxBarrierCount <= 32, "PawnInGapMask has a bit per barrier");
+
+	Box2DPhysics() { m_world.SetContactListener(this); }
+
+	Box2DPhysics(const Box2DPhysics&) = delete;
+	Box2DPhysics& operator=(const Box2DPhysics&) = delete;
+
+	const b2World& GetWorld() const noexcept { return m_world; }
+
+	// Rewinds to an empty episode without tearing down the world: barriers go back to the pool, and the next
+	// CreateGround and CreatePawn move the existing bodies into place. Bodies, fixtures and contacts live in the
+	// world's block allocator, which keeps its chunks, so restarting an episode allocates nothing once warm.
+	void Clear() {
+		while (m_barrierCount) RemoveFrontBarrier();
+
+		m_world.SetGravity({ 0, 0 });
+
+		m_restoredPawnInGapMask.reset();
+	}
+
+	void Save(SavedState& state) const {
+		state.Gravity = m_world.GetGravity();
+		state.GroundPositionX = m_ground->GetPosition().x;
+		state.PawnPosition = m_pawn->GetPosition();
+		state.PawnLinearVelocity = m_pawn->GetLinearVelocity();
+		state.PawnAngle = m_pawn->GetAngle();
+		state.PawnAngularVelocity = m_pawn->GetAngularVelocity();
+		state.BarrierCount = static_cast<uint32_t>(m_barrierCount);
+		state.PawnInGapMask = 0;
+		for (size_t i = 0; i < m_barrierCount; i++) {
+			state.Barriers[i] = GetBarrier(i);
+			if (IsPawnInGap(i)) state.PawnInGapMask |= 1u << i;
+		}
+	}
+
+	// Whether state fits, for states read from outside the process.
+	static bool CanRestore(const SavedState& state) noexcept { return state.BarrierCount <= MaxBarrierCount; }
+
+	void Restore(const SavedState& state) {
+		m_world.SetGravity(state.Gravity);
+
+		m_ground->SetTransform({ state.GroundPositionX, m_ground->GetPosition().y }, 0);
+
+		// Disabling destroys the pawn's contacts, so that none survive from before the restore to end on the next Step.
+		m_pawn->SetEnabled(false);
+		m_pawn->SetTransform(state.PawnPosition, state.PawnAngle);
+		m_pawn->SetLinearVelocity(state.PawnLinearVelocity);
+		m_pawn->SetAngularVelocity(state.PawnAngularVelocity);
+		m_pawn->SetEnabled(true);
+		m_pawn->SetAwake(true);
+
+		m_restoredPawnInGapMask = state.PawnInGapMask;
+
+		while (m_barrierCount > state.BarrierCount) RemoveFrontBarrier();
+
+		for (size_t i = 0; i < state.BarrierCount; i++) {
+			const auto& saved = state.Barriers[i];
+			if (i == m_barrierCount) {
+				AddBarrier(saved.PositionX, saved.HalfWidth, saved.GapBottom / 2, (saved.GapTop - saved.GapBottom) / 2, (saved.Top - saved.GapTop) / 2);
+				continue;
+			}
+
+			auto& barrier = GetBarrierSlot(i);
+			if (barrier.HalfWidth != saved.HalfWidth || barrier.GapBottom != saved.GapBottom || barrier.GapTop != saved.GapTop || barrier.Top != saved.Top) {
+				ReshapeBarrier(barrier, saved.HalfWidth, saved.GapBottom / 2, (saved.GapTop - saved.GapBottom) / 2, (saved.Top - saved.GapTop) / 2);
+			}
+			barrier.Body->SetTransform({ saved.PositionX, 0 }, 0);
+		}
+	}
+
+	// Bodies created since construction. Barriers are recycled and Clear keeps every body, so this stays flat while
+	// a game is running and across resets.
+	uint64_t GetCreatedBodyCount() const noexcept { return m_createdBodyCount; }
+
+	b2Vec2 GetGravity() const { return m_world.GetGravity(); }
+	void SetGravity(b2Vec2 value) { m_world.SetGravity(value); }
+
+	void CreateGround(b2Vec2 position, b2Vec2 halfSize) {
+		if (m_ground) {
+			static_cast<b2PolygonShape*>(m_ground->GetFixtureList()->GetShape())->SetAsBox(halfSize.x, halfSize.y);
+			m_ground->SetTransform(position, 0);
+			return;
+		}
+
+		b2BodyDef bodyDef;
+		bodyDef.position = position;
+		const auto body = CreateBody(bodyDef);
+
+		b2PolygonShape shape;
+		shape.SetAsBox(halfSize.x, halfSize.y);
+		b2FixtureDef fixtureDef;
+		fixtureDef.shape = &shape;
+		fixtureDef.friction = 0.6f;
+		body->CreateFixture(&fixtureDef);
+
+		m_ground = body;
+	}
+
+	void MoveGround(float x) {
+		auto position = m_ground->GetPosition();
+		position.x += x;
+		m_ground->SetTransform(position, 0);
+	}
+
+	void CreatePawn(b2Vec2 position, b2Vec2 linearVelocity, float radius) {
+		if (m_pawn) {
+			if (const auto shape = m_pawn->GetFixtureList()->GetShape(); shape->m_radius != radius) {
+				shape->m_radius = radius;
+				m_pawn->ResetMassData();
+			}
+			m_pawn->SetTransform(position, 0);
+			m_pawn->SetLinearVelocity(linearVelocity);
+			m_pawn->SetAngularVelocity(0);
+			m_pawn->SetAwake(true);
+			return;
+		}
+
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		bodyDef.position = position;
+		bodyDef.linearVelocity = linearVelocity;
+		const auto body = CreateBody(bodyDef);
+
+		b2CircleShape shape;
+		shape.m_radius = radius;
+		b2FixtureDef fixtureDef;
+		fixtureDef.shape = &shape;
+		fixtureDef.density = 1;
+		fixtureDef.friction = 0.5f;
+		fixtureDef.userData.pointer = static_cast<uintptr_t>(ObjectType::Pawn);
+		body->CreateFixture(&fixtureDef);
+
+		m_pawn = body;
+	}
+
+	b2Vec2 GetPawnPosition() const { return m_pawn->GetPosition(); }
+
+	float GetPawnAngle() const { return m_pawn->GetAngle(); }
+
+	float GetPawnAngularVelocity() const { return m_pawn->GetAngularVelocity(); }
+
+	b2Vec2 GetPawnLinearVelocity() const { return m_pawn->GetLinearVelocity(); }
+	void SetPawnLinearVelocity(b2Vec2 value) { m_pawn->SetLinearVelocity(value); }
+
+	// Barriers are stacked from the ground up: a solid bottom box, a sensor spanning the gap and a solid top box.
+	// Removed barriers are disabled and kept, and the next AddBarrier reshapes and moves one of them back into place.
+	void AddBarrier(float positionX, float halfWidth, float bottomHalfHeight, float gapHalfHeight, float topHalfHeight) {
+		if (m_barrierCount == MaxBarrierCount) throw std::length_error("Too many barriers");
+
+		if (!m_barrierPool.empty()) {
+			Barrier barrier{ m_barrierPool.back() };
+			m_barrierPool.pop_back();
+
+			ReshapeBarrier(barrier, halfWidth, bottomHalfHeight, gapHalfHeight, topHalfHeight);
+			barrier.Body->SetTransform({ positionX, 0 }, 0);
+			barrier.Body->SetEnabled(true);
+
+			GetBarrierSlot(m_barrierCount++) = barrier;
+			return;
+		}
+
+		b2BodyDef bodyDef;
+		bodyDef.position.x = positionX;
+		const auto body = CreateBody(bodyDef);
+
+		const auto CreateFixture = [&](float halfHeight, float positionY, ObjectType objectType) {
+			b2PolygonShape shape;
+			shape.SetAsBox(halfWidth, halfHeight, { 0, positionY }, 0);
+			b2FixtureDef fixtureDef;
+			fixtureDef.shape = &shape;
+			fixtureDef.friction = 0.3f;
+			fixtureDef.isSensor = objectType == ObjectType::Unknown;
+			fixtureDef.userData.pointer = static_cast<uintptr_t>(objectType);
+			body->CreateFixture(&fixtureDef);
+		};
+		CreateFixture(bottomHalfHeight, bottomHalfHeight, ObjectType::BarrierBottom);
+		CreateFixture(gapHalfHeight, bottomHalfHeight * 2 + gapHalfHeight, ObjectType::Unknown);
+		CreateFixture(topHalfHeight, (bottomHalfHeight + gapHalfHeight) * 2 + topHalfHeight, ObjectType::BarrierTop);
+
+		const auto gapBottom = bottomHalfHeight * 2, gapTop = gapBottom + gapHalfHeight * 2;
+		GetBarrierSlot(m_barrierCount++) = { body, halfWidth, gapBottom, gapTop, gapTop + topHalfHeight * 2 };
+	}
+
+	void RemoveFrontBarrier() {
+		const auto body = GetBarrierSlot(0).Body;
+		body->SetEnabled(false);
+		m_barrierPool.emplace_back(body);
+		m_barrierFront = (m_barrierFront + 1) % MaxBarrierCount;
+		m_barrierCount--;
+	}
+
+	size_t GetBarrierCount() const noexcept { return m_barrierCount; }
+
+	float GetBarrierPositionX(size_t index) const { return GetBarrierSlot(index).Body->GetPosition().x; }
+
+	PhysicsBarrier GetBarrier(size_t index) const {
+		const auto& barrier = GetBarrierSlot(index);
+		return { barrier.Body->GetPosition().x, barrier.HalfWidth, barrier.GapBottom, barrier.GapTop, barrier.Top };
+	}
+
+	template <typename TCallback>
+	void ForEachSprite(TCallback&& callback) const {
+		for (auto body = m_world.GetBodyList(); body != nullptr; body = body->GetNext()) {
+			if (!body->IsEnabled()) continue;
+
+			const auto& bodyTransform = body->GetTransform();
+
+			for (auto fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext()) {
+				if (fixture->IsSensor()) continue;
+
+				const auto objectType = static_cast<ObjectType>(const_cast<b2Fixture*>(fixture)->GetUserData().pointer);
+				if (objectType == ObjectType::Unknown) continue;
+
+				const auto shape = fixture->GetShape();
+
+				Sprite sprite{ objectType, false, bodyTransform.p.x, bodyTransform.p.y, bodyTransform.p.x, bodyTransform.p.y, bodyTransform.q.GetAngle() };
+				switch (shape->GetType()) {
+				case b2Shape::e_circle: {
+					const auto radius = static_cast<const b2CircleShape*>(shape)->m_radius;
+					sprite.IsEllipse = true;
+					sprite.Left += -radius;
+					sprite.Top += radius;
+					sprite.Right += radius;
+					sprite.Bottom += -radius;
+				} break;
+
+				case b2Shape::e_polygon: {
+					const auto& vertices = static_cast<const b2PolygonShape*>(shape)->m_vertices;
+					sprite.Left += vertices[3].x;
+					sprite.Top += vertices[3].y;
+					sprite.Right += vertices[1].x;
+					sprite.Bottom += vertices[1].y;
+				} break;
+
+				default: continue;
+				}
+
+				callback(sprite);
+			}
+		}
+	}
+
+	PhysicsContacts Step(float elapsedSeconds) {
+		TRACE_ZONE("Physics.Step");
+
+		m_contacts = {};
+
+		m_world.Step(elapsedSeconds, 8, 3);
+
+		if (m_restoredPawnInGapMask) {
+			m_contacts.GapsCleared = 0;
+			for (size_t i = 0; i < m_barrierCount; i++) {
+				if ((*m_restoredPawnInGapMask >> i & 1) && !IsPawnInGap(i)) m_contacts.GapsCleared++;
+			}
+			m_restoredPawnInGapMask.reset();
+		}
+
+		// Gaps left on the step the pawn dies do not score.
+		if (m_contacts.IsHit) m_contacts.GapsCleared = 0;
+
+		return m_contacts;
+	}
+
+	void ShiftOrigin(b2Vec2 newOrigin) {
+		TRACE_ZONE("Physics.ShiftOrigin");
+
+		m_world.ShiftOrigin(newOrigin);
+	}
+
+private:
+	b2World m_world = decltype(m_world)({ 0, 0 });
+
+	b2Body* m_ground{};
+
+	b2Body* m_pawn{};
+
+	struct Barrier {
+		b2Body* Body{};
+		float HalfWidth{}, GapBottom{}, GapTop{}, Top{};
+	};
+	std::array<Barrier, MaxBarrierCount> m_barriers;
+	size_t m_barrierFront{}, m_barrierCount{};
+
+	std::vector<b2Body*> m_barrierPool;
+
+	Barrier& GetBarrierSlot(size_t index) noexcept { return m_barriers[(m_barrierFront + index) % MaxBarrierCount]; }
+	const Barrier& GetBarrierSlot(size_t index) const noexcept { return m_barriers[(m_barrierFront + index) % MaxBarrierCount]; }
+
+	uint64_t m_createdBodyCount{};
+
+	b2Body* CreateBody(const b2BodyDef& bodyDef) {
+		m_createdBodyCount++;
+		return m_world.CreateBody(&bodyDef);
+	}
+
+	// Resizes the fixtures of an existing barrier body. The broadphase picks up the new bounds on the body's next
+	// SetTransform, or when it is enabled again.
+	static void ReshapeBarrier(Barrier& barrier, float halfWidth, float bottomHalfHeight, float gapHalfHeight, float topHalfHeight) {
+		for (auto fixture = barrier.Body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext()) {
+			const auto shape = static_cast<b2PolygonShape*>(fixture->GetShape());
+			switch (static_cast<ObjectType>(fixture->GetUserData().pointer)) {
+			case ObjectType::BarrierBottom: shape->SetAsBox(halfWidth, bottomHalfHeight, { 0, bottomHalfHeight }, 0); break;
+			case ObjectType::Unknown: shape->SetAsBox(halfWidth, gapHalfHeight, { 0, bottomHalfHeight * 2 + gapHalfHeight }, 0); break;
+			case ObjectType::BarrierTop: shape->SetAsBox(halfWidth, topHalfHeight, { 0, (bottomHalfHeight + gapHalfHeight) * 2 + topHalfHeight }, 0); break;
+			default: break;
+			}
+		}
+
+		const auto gapBottom = bottomHalfHeight * 2, gapTop = gapBottom + gapHalfHeight * 2;
+		barrier.HalfWidth = halfWidth;
+		barrier.GapBottom = gapBottom;
+		barrier.GapTop = gapTop;
+		barrier.Top = gapTop + topHalfHeight * 2;
+	}
+
+	PhysicsContacts m_contacts{};
+
+	// Set by Restore until the next Step.
+	std::optional<uint32_t> m_restoredPawnInGapMask;
+
+	// Whether the pawn's contact with the barrier's gap sensor is touching, as of the last Step.
+	bool IsPawnInGap(size_t index) const {
+		const auto body = GetBarrierSlot(index).Body;
+		for (auto edge = m_pawn->GetContactList(); edge != nullptr; edge = edge->next) {
+			if (edge->other == body && edge->contact->IsTouching() && (edge->contact->GetFixtureA()->IsSensor() || edge->contact->GetFixtureB()->IsSensor())) return true;
+		}
+		return false;
+	}
+
+	void BeginContact(b2Contact* contact) override {
+		if (!contact->GetFixtureA()->IsSensor() && !contact->GetFixtureB()->IsSensor()) m_contacts.IsHit = true;
+	}
+
+	void EndContact(b2Contact* contact) override {
+		if (contact->GetFixtureA()->IsSensor() || contact->GetFixtureB()->IsSensor()) m_contacts.GapsCleared++;
+	}
+};
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Game.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Checks whether generated courses can be flown at all, without playing them, Simd::Width seeds at a time.
+//
+// A flap sets the vertical velocity to the one that rises FlyUpHeight, so whatever the pawn does while it passes a
+// barrier, the heights it covers span at least MinimumArcHeight. The lowest of them is where it last flapped, and
+// that point has to lie in a band at least Reach above the gap bottom and MinimumArcHeight + Reach below the gap top.
+// Between two gaps the flap point can rise at most as fast as flapping every MinFlapIntervalSeconds allows and fall
+// at most as far as a single flap and gravity take it. Propagating the band from gap to gap gives the heights that
+// are still reachable; a course is impossible once none are.
+//
+// The model is continuous in time, treats barriers as rectangles and assumes the pawn flaps at the same point of
+// every gap, so it is a screen rather than a proof. The margin is the width of the narrowest reachable band.
+class CourseAnalyzer {
+public:
+	struct Rules {
+		float WorldHeight = 12, Gravity = 10, PawnVelocityX = 2;
+
+		float FlyUpHeight = AnalyticGame::PawnRadius * 2 * 1.7f;
+
+		float Reach = AnalyticGame::PawnRadius + AnalyticPhysics::ContactSkin;
+
+		float GapHeight = AnalyticGame::PawnRadius * 2.8f * 2, MinGapBottom = 0.3f, MaxGapBottom = 0.5f;
+
+		float BarrierWidth = AnalyticGame::BarrierWidth, BarrierDistance = AnalyticGame::BarrierDistance;
+
+		float MinFlapIntervalSeconds = 1 / 60.0f;
+
+		// Courses whose margin is below this are reported as tight.
+		float TightMargin = 0.05f;
+	};
+
+	enum class Verdict : uint8_t { Feasible, Tight, Impossible };
+
+	CourseAnalyzer() : CourseAnalyzer(Rules()) {}
+
+	explicit CourseAnalyzer(const Rules& rules) : m_rules(rules) {
+		const auto g = rules.Gravity, v = std::sqrt(2 * g * rules.FlyUpHeight);
+
+		// Passing a barrier takes T. Flapping once at s covers the fall before it, from an apex at best, and the rise
+		// after it; not flapping covers a parabola centered in T. Flapping more only climbs further.
+		const auto T = (rules.BarrierWidth + 2 * rules.Reach) / rules.PawnVelocityX;
+		const auto Rise = [&](float t) { return t < v / g ? v * t - g * t * t / 2 : rules.FlyUpHeight; };
+
+		m_minimumArcHeight = g * T * T / 8;
+		for (int i = 0; i <= 1024; i++) {
+			const auto s = T * i / 1024;
+			m_minimumArcHeight = std::min(m_minimumArcHeight, std::max(g * s * s / 2, Rise(T - s)));
+		}
+
+		const auto t = rules.BarrierDistance / rules.PawnVelocityX;
+		m_maxClimb = std::max(v - g * rules.MinFlapIntervalSeconds / 2, 0.0f) * t;
+		m_minClimb = v * t - g * t * t / 2;
+	}
+
+	const Rules& GetRules() const noexcept { return m_rules; }
+
+	float GetMinimumArcHeight() const noexcept { return m_minimumArcHeight; }
+
+	// Gap bottom of barrier index on the course an AnalyticGame or Game seeded with seed generates.
+	float GetGapBottom(uint32_t seed, uint32_t index) const noexcept {
+		return m_rules.WorldHeight / 2 * Random(seed).FloatAt(index, m_rules.MinGapBottom, m_rules.MaxGapBottom) * 2;
+	}
+
+	Verdict Classify(float margin) const noexcept { return margin < 0 ? Verdict::Impossible : margin < m_rules.TightMargin ? Verdict::Tight : Verdict::Feasible; }
+
+	// Analyzes the first barrierCount barriers of the courses seeded firstSeed to firstSeed + count - 1. margins[i] is
+	// negative for an impossible course, and tightestBarriers[i], if given, the barrier where the margin is smallest.
+	void Analyze(uint32_t firstSeed, size_t count, uint32_t barrierCount, float* margins, uint32_t* tightestBarriers = nullptr) const {
+		using namespace Simd;
+
+		const auto
+			reach = Broadcast(m_rules.Reach),
+			bandHeight = Broadcast(m_rules.GapHeight - m_rules.Reach - m_minimumArcHeight),
+			maxClimb = Broadcast(m_maxClimb),
+			minClimb = Broadcast(m_minClimb),
+			worldHalfHeight = Broadcast(m_rules.WorldHeight / 2),
+			minGapBottom = Broadcast(m_rules.MinGapBottom),
+			gapBottomRange = Broadcast(m_rules.MaxGapBottom - m_rules.MinGapBottom);
+
+		for (size_t i = 0; i < count; i += Width) {
+			// Each lane draws from its course's stream as GetGapBottom does, only without seeding it again for every draw.
+			uint64_t laneKeys[Width];
+			for (size_t lane = 0; lane < Width; lane++) laneKeys[lane] = Random(static_cast<uint32_t>(firstSeed + i + lane)).GetKey();
+			const auto keys = Load(laneKeys);
+
+			const auto LoadGapBottoms = [&](uint32_t barrier) {
+				const auto fraction = ToFloat(ToInt(Random::GetBitsAt(keys, barrier))) * Broadcast(1.0f / (1 << 24));
+				return worldHalfHeight * (minGapBottom + gapBottomRange * fraction) * Broadcast(2);
+			};
+
+			// The pawn has several seconds before the first barrier, so any flap point in its band is reachable.
+			auto gapBottom = LoadGapBottoms(0);
+			auto low = gapBottom + reach, high = gapBottom + bandHeight;
+			auto margin = high - low;
+			auto tightestBarrier = BroadcastInt(0);
+
+			for (uint32_t barrier = 1; barrier < barrierCount; barrier++) {
+				gapBottom = LoadGapBottoms(barrier);
+				low = Max(low + minClimb, gapBottom + reach);
+				high = Min(high + maxClimb, gapBottom + bandHeight);
+
+				// The first barrier with no reachable band decides an impossible course.
+				const auto width = high - low;
+				const auto isTighter = (width < margin) & (margin >= Broadcast(0));
+				margin = Select(isTighter, width, margin);
+				tightestBarrier = Select(isTighter, BroadcastInt(static_cast<int32_t>(barrier)), tightestBarrier);
+			}
+
+			float laneMargins[Width];
+			int32_t laneBarriers[Width];
+			Store(laneMargins, margin);
+			Store(laneBarriers, tightestBarrier);
+
+			const auto laneCount = std::min(Width, count - i);
+			std::copy_n(laneMargins, laneCount, margins + i);
+			if (tightestBarriers != nullptr) std::copy_n(laneBarriers, laneCount, tightestBarriers + i);
+		}
+	}
+
+private:
+	Rules m_rules;
+
+	float m_minimumArcHeight, m_maxClimb, m_minClimb;
+};
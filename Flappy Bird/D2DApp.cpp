@@ -3,11 +3,20 @@ module;
 
 #include "StepTimer.h"
 
-#include "box2d/box2d.h"
+#include "Game.h"
 
-#include "Random.h"
+#include "D2DRenderer.h"
 
-#include <queue>
+#include "SimulationThread.h"
+
+#include "InputQueue.h"
+
+#include "GameEventWriter.h"
+
+#include <cerrno>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 
 module D2DApp;
 
@@ -19,13 +28,85 @@ using namespace Microsoft::WRL;
 using namespace std;
 using namespace WindowHelpers;
 
-struct D2DApp::Impl : b2ContactListener {
-	Impl(const shared_ptr<WindowModeHelper>& windowModeHelper) noexcept(false) : m_windowModeHelper(windowModeHelper) {
+struct D2DApp::Impl {
+	Impl(const shared_ptr<WindowModeHelper>& windowModeHelper, optional<uint32_t> seed, bool isSimulationThreaded, uint32_t tickRate, const filesystem::path& eventLogPath) noexcept(false) :
+		m_windowModeHelper(windowModeHelper), m_stepSeconds(1.0 / tickRate), m_isDeterministic(seed.has_value()) {
 		CreateDeviceDependentResources();
 
 		CreateWindowSizeDependentResources();
 
-		InitializeWorld();
+		if (!eventLogPath.empty()) {
+			m_eventFile.open(eventLogPath, ios::binary);
+			if (!m_eventFile) throw filesystem::filesystem_error("Cannot open the event log", eventLogPath, error_code(errno, generic_category()));
+
+			m_eventWriter.emplace(m_events, m_eventFile);
+			m_game.SetEventQueue(&m_events);
+		}
+
+		m_stepTimer.SetFixedTimeStep(true);
+		m_stepTimer.SetTargetElapsedSeconds(m_stepSeconds);
+
+		if (m_isDeterministic) m_game.Reset(*seed);
+
+		m_snapshot.Capture(m_game);
+		m_previousSnapshot = m_frameSnapshot = m_snapshot;
+
+		if (isSimulationThreaded) {
+			m_simulation.emplace(m_stepSeconds, TickSnapshots{ m_snapshot, m_snapshot, chrono::steady_clock::now() }, [&](float elapsedSeconds) {
+				TRACE_ZONE("Update");
+
+				Update(elapsedSeconds);
+			}, [&](TickSnapshots& snapshots) {
+				snapshots.Previous = m_snapshot;
+				m_snapshot.Capture(m_game);
+				snapshots.Current = m_snapshot;
+				snapshots.Time = chrono::steady_clock::now();
+			}, [&] { m_inputLatency.Publish(); });
+		}
+	}
+
+	~Impl() {
+		m_simulation.reset();
+
+		const auto Output = [](const char* name, const DurationSamples::Statistics& statistics) {
+			char message[128];
+			sprintf_s(message, "%s over %zu samples: mean %.1f us, p99 %.1f us, max %.1f us\n", name, statistics.Count, statistics.MeanMicroseconds, statistics.P99Microseconds, statistics.MaxMicroseconds);
+			OutputDebugStringA(message);
+		};
+		Output("Tick jitter", m_tickJitter.GetStatistics());
+		Output("Input to step latency", m_inputLatency.GetStepStatistics());
+		Output("Input to present latency", m_inputLatency.GetPresentStatistics());
+		Output("Gradient bake", m_renderer.GetBakeStatistics());
+
+		if (FILETIME creationTime, exitTime, kernelTime, userTime; GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+			constexpr auto ToSeconds = [](FILETIME time) { return static_cast<double>(static_cast<uint64_t>(time.dwHighDateTime) << 32 | time.dwLowDateTime) / 10000000; };
+			const auto seconds = chrono::duration<double>(chrono::steady_clock::now() - m_startTime).count();
+			char message[128];
+			sprintf_s(message, "CPU time at %.0f ticks per second: %.1f ms per second over %.1f s\n", 1 / m_stepSeconds, (ToSeconds(kernelTime) + ToSeconds(userTime)) * 1000 / seconds, seconds);
+			OutputDebugStringA(message);
+		}
+
+		const auto& gradientStatistics = m_renderer.GetGradientStatistics();
+		char message[128];
+		sprintf_s(message, "Gradient cache: %llu hits, %llu misses, %llu evictions\n", gradientStatistics.Hits, gradientStatistics.Misses, gradientStatistics.Evictions);
+		OutputDebugStringA(message);
+
+#ifdef FLAPPY_BIRD_ENABLE_TRACING
+		const auto events = Trace::Collect();
+
+		ofstream file("Trace.json");
+		Trace::WriteChromeJson(file, events);
+
+		ostringstream statistics;
+		Trace::WriteStatistics(statistics, events);
+		OutputDebugStringA(statistics.str().c_str());
+#endif
+
+#ifdef FLAPPY_BIRD_TRACK_ALLOCATIONS
+		ostringstream allocations;
+		AllocationTracker::WriteReport(allocations, m_updateCount);
+		OutputDebugStringA(allocations.str().c_str());
+#endif
 	}
 
 	SIZE GetOutputSize() const noexcept {
@@ -34,11 +115,40 @@ struct D2DApp::Impl : b2ContactListener {
 	}
 
 	void Tick() {
-		m_stepTimer.Tick([&] { Update(); });
+		TRACE_ZONE("Frame");
+
+		if (m_simulation) {
+			const auto unpresentedInputTime = m_inputLatency.GetUnpresented();
+			const auto& snapshots = m_simulation->AcquireSnapshot();
+			const auto alpha = chrono::duration<double>(chrono::steady_clock::now() - snapshots.Time).count() / m_stepSeconds;
+			m_frameSnapshot.Interpolate(snapshots.Previous, snapshots.Current, static_cast<float>(min(alpha, 1.0)));
+			Render(m_frameSnapshot);
+			m_inputLatency.RecordPresent(unpresentedInputTime, chrono::steady_clock::now());
+			return;
+		}
+
+		m_stepTimer.Tick([&] {
+			TRACE_ZONE("Update");
+
+			Update(static_cast<float>(m_stepTimer.GetElapsedSeconds()));
+
+			m_previousSnapshot = m_snapshot;
+			m_snapshot.Capture(m_game);
+			m_inputLatency.Publish();
+		});
+
+		if (!m_stepTimer.GetFrameCount()) return;
 
-		Render();
+		// Frames between ticks only blend the last two, so the physics costs the same at any refresh rate.
+		m_frameSnapshot.Interpolate(m_previousSnapshot, m_snapshot, static_cast<float>(m_stepTimer.GetInterpolationFactor()));
+
+		const auto unpresentedInputTime = m_inputLatency.GetUnpresented();
+		Render(m_frameSnapshot);
+		m_inputLatency.RecordPresent(unpresentedInputTime, chrono::steady_clock::now());
 	}
 
+	bool IsIdle() const noexcept { return !m_frameSnapshot.IsRunning; }
+
 	void OnWindowSizeChanged() {
 		const auto outputSize = GetOutputSize();
 		if (const auto resolution = m_windowModeHelper->GetResolution(); resolution.cx != outputSize.cx || resolution.cy != outputSize.cy) {
@@ -50,7 +160,7 @@ struct D2DApp::Impl : b2ContactListener {
 		}
 	}
 
-	void OnResuming() { m_stepTimer.ResetElapsedTime(); }
+	void OnResuming() { if (!m_simulation) m_stepTimer.ResetElapsedTime(); }
 
 	void OnSuspending() {}
 
@@ -60,10 +170,7 @@ struct D2DApp::Impl : b2ContactListener {
 
 	void ProcessKeyboardMessage(UINT uMsg, WPARAM wParam, LPARAM lParam) {
 		switch (uMsg) {
-		case WM_KEYDOWN: {
-			if (m_state == State::Over) Reset();
-			else if (wParam == VK_SPACE && !(HIWORD(lParam) & KF_REPEAT)) FlyUp();
-		} break;
+		case WM_KEYDOWN: m_inputs.TryPush({ chrono::steady_clock::now(), wParam == VK_SPACE && !(HIWORD(lParam) & KF_REPEAT) }); break;
 		}
 	}
 
@@ -72,10 +179,7 @@ struct D2DApp::Impl : b2ContactListener {
 		case WM_LBUTTONDOWN:
 		case WM_RBUTTONDOWN:
 		case WM_MBUTTONDOWN:
-		case WM_XBUTTONDOWN: {
-			if (m_state == State::Over) Reset();
-			else if (wParam & MK_LBUTTON) FlyUp();
-		} break;
+		case WM_XBUTTONDOWN: m_inputs.TryPush({ chrono::steady_clock::now(), (wParam & MK_LBUTTON) != 0 }); break;
 		}
 	}
 
@@ -88,96 +192,48 @@ private:
 
 	StepTimer m_stepTimer;
 
-	D2D1_MATRIX_3X2_F m_transform{};
-
-	struct Images {
-		ComPtr<ID2D1ImageBrush> Background, Pawn, Barrier;
-
-		Images() = default;
+	const double m_stepSeconds;
+	const chrono::steady_clock::time_point m_startTime = chrono::steady_clock::now();
 
-		Images(ID2D1DeviceContext* pDeviceContext) {
-			const auto CreateImageBrush = [&](D2D1_SIZE_F size, ID2D1ImageBrush** ppBrush) {
-				ComPtr<ID2D1BitmapRenderTarget> bitmapRenderTarget;
-				ThrowIfFailed(pDeviceContext->CreateCompatibleRenderTarget(size, &bitmapRenderTarget));
+	const bool m_isDeterministic;
+	uint64_t m_stateHash = StateHash::OffsetBasis;
 
-				ComPtr<ID2D1Bitmap> bitmap;
-				ThrowIfFailed(bitmapRenderTarget->GetBitmap(&bitmap));
-				ThrowIfFailed(pDeviceContext->CreateImageBrush(bitmap.Get(), ImageBrushProperties({ 0, 0, size.width, size.height }), BrushProperties(1, Matrix3x2F::Scale(1 / size.width, 1 / size.height)), ppBrush));
+	D2DRenderer m_renderer;
 
-				return bitmapRenderTarget;
-			};
+	SpriteBatch m_spriteBatch;
 
-			const auto Render = [&](initializer_list<D2D1_GRADIENT_STOP> gradientStops, const D2D1_LINEAR_GRADIENT_BRUSH_PROPERTIES& gradientBrushProperties, D2D1_SIZE_F size, ID2D1ImageBrush** ppBrush) {
-				const auto renderTarget = CreateImageBrush(size, ppBrush);
+	Game m_game;
 
-				renderTarget->BeginDraw();
+	ofstream m_eventFile;
+	GameEventQueue m_events;
+	optional<GameEventWriter> m_eventWriter;
 
-				ComPtr<ID2D1GradientStopCollection> gradientStopCollection;
-				ThrowIfFailed(pDeviceContext->CreateGradientStopCollection(gradientStops.begin(), static_cast<UINT32>(gradientStops.size()), &gradientStopCollection));
+	// Inputs and resizes reach the game at the next tick, on whichever thread runs it. A tick covers the simulated
+	// interval after the previous one, so ticks that catch up within one frame each take only the inputs stamped before
+	// their end, and each input is applied at the matching time within the step.
+	InputQueue m_inputs;
+	atomic<float> m_pendingWorldAspectRatio;
 
-				ComPtr<ID2D1LinearGradientBrush> linearGradientBrush;
-				ThrowIfFailed(pDeviceContext->CreateLinearGradientBrush(gradientBrushProperties, gradientStopCollection.Get(), &linearGradientBrush));
+	chrono::steady_clock::time_point m_lastTickTime;
+	vector<float> m_flyUpOffsets;
+	vector<chrono::steady_clock::time_point> m_appliedInputTimes;
 
-				renderTarget->FillRectangle({ 0, 0, size.width, size.height }, linearGradientBrush.Get());
+	TickJitter m_tickJitter;
 
-				ThrowIfFailed(renderTarget->EndDraw());
-			};
+	uint64_t m_updateCount{};
 
-			const auto deviceContextSize = pDeviceContext->GetSize();
+	InputLatency m_inputLatency;
 
-			Render(
-				{
-					GradientStop(0, ColorF(ColorF::WhiteSmoke)),
-					GradientStop(1, ColorF(ColorF::LightSkyBlue))
-				},
-				LinearGradientBrushProperties({}, { 0, deviceContextSize.height }),
-				deviceContextSize,
-				&Background
-			);
+	// The last two ticks, owned by whichever thread runs them, and the frame drawn between them.
+	RenderSnapshot m_snapshot, m_previousSnapshot, m_frameSnapshot;
 
-			const D2D1_SIZE_F imageSize{ deviceContextSize.width * 0.1f, deviceContextSize.height * 0.1f };
-
-			Render(
-				{
-					GradientStop(0, ColorF(ColorF::WhiteSmoke)),
-					GradientStop(1, ColorF(ColorF::DarkCyan))
-				},
-				LinearGradientBrushProperties({}, { imageSize.width, 0 }),
-				imageSize,
-				&Pawn
-			);
-
-			Render(
-				{
-					GradientStop(0, ColorF(ColorF::WhiteSmoke)),
-					GradientStop(1, ColorF(ColorF::LightSkyBlue))
-				},
-				LinearGradientBrushProperties({}, { 0, imageSize.height }),
-				imageSize,
-				&Barrier
-			);
-		}
+	// The last two ticks and when the second was captured, handed from the simulation thread to the render thread.
+	struct TickSnapshots {
+		RenderSnapshot Previous, Current;
+		chrono::steady_clock::time_point Time;
 	};
-	Images m_images;
-
-	enum class ObjectType { Unknown, Pawn, BarrierTop, BarrierBottom };
-
-	b2Vec2 m_worldSize{ 0, 12 };
-	b2World m_world = decltype(m_world)({ 0, 0 });
-
-	b2Body* m_ground{};
-
-	static constexpr float PawnRadius = 0.5f;
-	b2Body* m_pawn{};
-
-	static constexpr float BarrierWidth = PawnRadius * 2 * 1.7f, BarrierDistance = 5;
-	queue<b2Body*> m_barriers;
-
-	enum class State { NotStarted, Running, Over } m_state{};
-
-	uint32_t m_score{};
 
-	Random m_random;
+	optional<SimulationThread<TickSnapshots>> m_simulation;
 
 	void CreateDeviceDependentResources() {
 		D2D1_FACTORY_OPTIONS factoryOptions{};
@@ -192,269 +248,80 @@ private:
 		const auto resolution = m_windowModeHelper->GetResolution();
 		ThrowIfFailed(m_d2dFactory->CreateHwndRenderTarget({}, HwndRenderTargetProperties(m_windowModeHelper->hWnd, { static_cast<UINT32>(resolution.cx), static_cast<UINT32>(resolution.cy) }), &hwndRenderTarget));
 		ThrowIfFailed(hwndRenderTarget.As(&m_d2dDeviceContext));
+
+		m_renderer = D2DRenderer(m_d2dDeviceContext.Get(), m_dWriteFactory.Get());
 	}
 
 	void CreateWindowSizeDependentResources() {
-		m_images = m_d2dDeviceContext.Get();
-
-		const auto deviceContextSize = m_d2dDeviceContext->GetSize();
-
-		const auto worldWidth = m_worldSize.y * deviceContextSize.width / deviceContextSize.height;
-
-		m_world.ShiftOrigin({ (m_worldSize.x - worldWidth) / 2, 0 });
+		m_renderer.CreateWindowSizeDependentResources();
 
-		m_worldSize.x = worldWidth;
-
-		const auto scale = deviceContextSize.height / m_worldSize.y;
-		m_transform = Matrix3x2F::Scale(scale, -scale) * Matrix3x2F::Translation((deviceContextSize.width - m_worldSize.x * scale) / 2, deviceContextSize.height);
+		const auto size = m_renderer.GetSize();
+		if (m_simulation) m_pendingWorldAspectRatio = size.x / size.y;
+		else m_game.SetWorldWidth(m_game.GetWorldSize().y * size.x / size.y);
 	}
 
-	void Update() {
-		const auto elapsedSeconds = static_cast<float>(m_stepTimer.GetElapsedSeconds());
-
-		if (m_state == State::NotStarted) {
-			constexpr auto CalculateSpringOscillatorVelocity = [](float a, float ω, float t, float φ) { return -a * ω * sin(ω * t - φ); };
-
-			auto v = m_pawn->GetLinearVelocity();
-			v.y = CalculateSpringOscillatorVelocity(0.1f, 2 * b2_pi / 0.8f, static_cast<float>(m_stepTimer.GetTotalSeconds()), 0);
-			m_pawn->SetLinearVelocity(v);
-		}
-
-		const auto pawnPositionX = m_pawn->GetPosition().x;
-
-		m_world.Step(elapsedSeconds, 8, 3);
-
-		const auto pawnDisplacementX = m_pawn->GetPosition().x - pawnPositionX;
-
-		auto groundPosition = m_ground->GetPosition();
-		groundPosition.x += m_pawn->GetPosition().x - pawnPositionX;
-		m_ground->SetTransform(groundPosition, 0);
-
-		m_world.ShiftOrigin({ pawnDisplacementX, 0 });
-
-		if (m_state == State::Running) {
-			if (const auto barrier = m_barriers.front(); barrier->GetPosition().x - BarrierWidth / 2 + BarrierDistance < 0) {
-				AddBarrier();
-				m_world.DestroyBody(barrier);
-				m_barriers.pop();
+	void Update(float elapsedSeconds) {
+		const auto time = chrono::steady_clock::now();
+		const auto step = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<float>(elapsedSeconds));
+
+		// The first tick, and one after a stall that StepTimer and SimulationThread skip rather than catch up on, ends now.
+		constexpr auto MaxLag = chrono::milliseconds(200);
+		auto lastTime = m_lastTickTime;
+		if (time - lastTime > MaxLag) lastTime = time - step;
+		const auto tickTime = m_lastTickTime = lastTime + step;
+
+		m_tickJitter.Record(time, elapsedSeconds);
+
+		m_updateCount++;
+
+		if (const auto aspectRatio = m_pendingWorldAspectRatio.exchange(0); aspectRatio > 0) m_game.SetWorldWidth(m_game.GetWorldSize().y * aspectRatio);
+
+		m_flyUpOffsets.clear();
+		m_appliedInputTimes.clear();
+		for (InputEvent input; m_inputs.TryPopIf(input, [&](const InputEvent& queued) { return queued.Time < tickTime; });) {
+			if (m_game.GetState() == Game::State::Over) m_game.Reset();
+			else if (input.IsFlyUp) {
+				// Deterministic runs fly up at the start of the tick, so that the hash stream depends only on which tick
+				// each input reached and not on when within it.
+				if (m_isDeterministic) m_flyUpOffsets.emplace_back(0.0f);
+				else {
+					const auto offset = chrono::duration<float>(input.Time - lastTime).count();
+					m_flyUpOffsets.emplace_back(clamp(offset, 0.0f, elapsedSeconds));
+				}
 			}
-		}
-	}
-
-	void Render() {
-		if (!m_stepTimer.GetFrameCount()) return;
-
-		m_d2dDeviceContext->BeginDraw();
-
-		RenderBackground();
-
-		RenderWorld();
+			else continue;
 
-		RenderUI();
-
-		ThrowIfFailed(m_d2dDeviceContext->EndDraw());
-	}
-
-	void FlyUp() {
-		switch (m_state) {
-		case State::NotStarted: {
-			m_world.SetGravity({ 0, -10 });
-
-			for (auto count = static_cast<uint32_t>(ceil((m_worldSize.x + BarrierDistance) / (BarrierDistance + BarrierWidth))); count; count--) AddBarrier();
-
-			m_state = State::Running;
-		} [[fallthrough]];
-
-		case State::Running: {
-			const auto x = PawnRadius * 2 * 1.7f, g = -m_world.GetGravity().y, t = sqrt(2 * x / g);
-			m_pawn->SetLinearVelocity({ m_pawn->GetLinearVelocity().x, g * t });
-		} break;
+			m_appliedInputTimes.emplace_back(input.Time);
 		}
-	}
 
-	void InitializeWorld() {
-		m_world.SetContactListener(this);
+		const auto state = m_game.GetState();
 
-		CreateGround();
+		m_game.Update(elapsedSeconds, m_flyUpOffsets);
 
-		Spawn();
-	}
-
-	void Reset() {
-		m_state = {};
-
-		m_score = {};
-
-		m_barriers = {};
-
-		m_world.~b2World();
-		new (&m_world) decltype(m_world)({ 0, 0 });
-
-		InitializeWorld();
-	}
+		const auto stepTime = chrono::steady_clock::now();
+		for (const auto inputTime : m_appliedInputTimes) m_inputLatency.RecordStep(inputTime, stepTime);
 
-	void CreateGround() {
-		const b2Vec2 halfSize{ 50, 0.1f };
+		if (m_isDeterministic) {
+			m_stateHash = StateHash(m_stateHash).Add(m_game.GetStateHash()).Get();
 
-		b2BodyDef bodyDef;
-		bodyDef.position.Set(m_worldSize.x / 2, -halfSize.y);
-		const auto body = m_world.CreateBody(&bodyDef);
-
-		b2PolygonShape shape;
-		shape.SetAsBox(halfSize.x, halfSize.y);
-		b2FixtureDef fixtureDef;
-		fixtureDef.shape = &shape;
-		fixtureDef.friction = 0.6f;
-		body->CreateFixture(&fixtureDef);
-
-		m_ground = body;
-	}
-
-	void Spawn() {
-		b2BodyDef bodyDef;
-		bodyDef.type = b2_dynamicBody;
-		bodyDef.position = { m_worldSize.x / 2 - PawnRadius, m_worldSize.y / 2 };
-		bodyDef.linearVelocity.x = 2;
-		const auto body = m_world.CreateBody(&bodyDef);
-
-		b2CircleShape shape;
-		shape.m_radius = PawnRadius;
-		b2FixtureDef fixtureDef;
-		fixtureDef.shape = &shape;
-		fixtureDef.density = 1;
-		fixtureDef.friction = 0.5f;
-		fixtureDef.userData.pointer = static_cast<uintptr_t>(ObjectType::Pawn);
-		body->CreateFixture(&fixtureDef);
-
-		m_pawn = body;
-	}
-
-	void AddBarrier() {
-		const auto
-			worldHalfHeight = m_worldSize.y / 2,
-			gapHalfHeight = PawnRadius * 2.8f,
-			bottomHalfHeight = worldHalfHeight * m_random.Float(0.3f, 0.5f), topHalfHeight = worldHalfHeight - gapHalfHeight - bottomHalfHeight;
-
-		b2BodyDef bodyDef;
-		bodyDef.position.x = m_barriers.empty() ? m_worldSize.x + BarrierWidth / 2 + 1 : m_barriers.back()->GetPosition().x + BarrierDistance;
-		const auto body = m_world.CreateBody(&bodyDef);
-
-		const auto CreateFixture = [&](float halfHeight, float positionY, ObjectType objectType) {
-			b2PolygonShape shape;
-			shape.SetAsBox(BarrierWidth / 2, halfHeight, { 0, positionY }, 0);
-			b2FixtureDef fixtureDef;
-			fixtureDef.shape = &shape;
-			fixtureDef.friction = 0.3f;
-			fixtureDef.isSensor = objectType == ObjectType::Unknown;
-			fixtureDef.userData.pointer = static_cast<uintptr_t>(objectType);
-			body->CreateFixture(&fixtureDef);
-		};
-		CreateFixture(bottomHalfHeight, bottomHalfHeight, ObjectType::BarrierBottom);
-		CreateFixture(gapHalfHeight, bottomHalfHeight * 2 + gapHalfHeight, ObjectType::Unknown);
-		CreateFixture(topHalfHeight, m_worldSize.y - topHalfHeight, ObjectType::BarrierTop);
-
-		m_barriers.emplace(body);
-	}
-
-	void BeginContact(b2Contact* contact) override {
-		if (!contact->GetFixtureA()->IsSensor() && !contact->GetFixtureB()->IsSensor()) m_state = State::Over;
-	}
-
-	void EndContact(b2Contact* contact) override {
-		if ((contact->GetFixtureA()->IsSensor() || contact->GetFixtureB()->IsSensor()) && m_state == State::Running) m_score++;
-	}
-
-	void RenderBackground() const {
-		ComPtr<ID2D1Image> image;
-		m_images.Background->GetImage(&image);
-		m_d2dDeviceContext->DrawImage(image.Get());
-	}
-
-	void RenderWorld() const {
-		D2D1_MATRIX_3X2_F transform;
-		m_d2dDeviceContext->GetTransform(&transform);
-
-		for (auto body = m_world.GetBodyList(); body != nullptr; body = body->GetNext()) {
-			const auto bodyTransform = body->GetTransform();
-
-			for (auto fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext()) {
-				if (fixture->IsSensor()) continue;
-
-				ID2D1Brush* pBrush;
-				auto angleDelta = 0.0f;
-				switch (static_cast<ObjectType>(const_cast<b2Fixture*>(fixture)->GetUserData().pointer)) {
-				case ObjectType::Pawn: pBrush = m_images.Pawn.Get(); break;
-
-				case ObjectType::BarrierTop: angleDelta = b2_pi; [[fallthrough]];
-				case ObjectType::BarrierBottom: pBrush = m_images.Barrier.Get(); break;
-
-				default: continue;
-				}
-
-				const auto shape = fixture->GetShape();
-				const auto shapeType = shape->GetType();
-
-				D2D1_RECT_F rect{ bodyTransform.p.x, bodyTransform.p.y, bodyTransform.p.x, bodyTransform.p.y };
-				switch (shapeType) {
-				case b2Shape::e_circle: {
-					const auto radius = dynamic_cast<const b2CircleShape*>(shape)->m_radius;
-					rect.left += -radius;
-					rect.top += radius;
-					rect.right += radius;
-					rect.bottom += -radius;
-				} break;
-
-				case b2Shape::e_polygon: {
-					const auto& vertices = dynamic_cast<const b2PolygonShape*>(shape)->m_vertices;
-					rect.left += vertices[3].x;
-					rect.top += vertices[3].y;
-					rect.right += vertices[1].x;
-					rect.bottom += vertices[1].y;
-				} break;
-
-				default: continue;
-				}
-
-				const D2D1_SIZE_F scale{ rect.right - rect.left, rect.bottom - rect.top };
-				m_d2dDeviceContext->SetTransform(Matrix3x2F::Scale(scale) * Matrix3x2F::Rotation((bodyTransform.q.GetAngle() + angleDelta) * 180 / b2_pi, { scale.width / 2, scale.height / 2 }) * Matrix3x2F::Translation(rect.left, rect.top) * m_transform);
-
-				if (shapeType == b2Shape::e_polygon) m_d2dDeviceContext->FillRectangle({ 0, 0, 1, 1 }, pBrush);
-				else m_d2dDeviceContext->FillEllipse({ { 0.5f, 0.5f }, 0.5f, 0.5f }, pBrush);
+			if (state != Game::State::Over && m_game.GetState() == Game::State::Over) {
+				char message[96];
+				sprintf_s(message, "Game over at tick %u, state hash %016llx\n", m_game.GetTickCount(), m_stateHash);
+				OutputDebugStringA(message);
 			}
 		}
-
-		m_d2dDeviceContext->SetTransform(transform);
 	}
 
-	void RenderUI() const {
-		const auto deviceContextSize = m_d2dDeviceContext->GetSize();
-
-		const auto RenderText = [&](LPCWSTR text, float fontSize, float positionY, UINT32 rgb) {
-			fontSize *= deviceContextSize.height;
-			positionY *= deviceContextSize.height;
+	void Render(const RenderSnapshot& snapshot) {
+		m_renderer.BeginFrame();
 
-			ComPtr<IDWriteTextFormat> dWriteTextFormat;
-			ThrowIfFailed(m_dWriteFactory->CreateTextFormat(L"Comic Sans MS", nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, fontSize, L"", &dWriteTextFormat));
-			ThrowIfFailed(dWriteTextFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER));
-			ThrowIfFailed(dWriteTextFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER));
+		RenderGame(m_renderer, snapshot, GetWorldTransform(m_renderer.GetSize(), snapshot.WorldSize), m_spriteBatch);
 
-			ComPtr<ID2D1SolidColorBrush> solidColorBrush;
-			ThrowIfFailed(m_d2dDeviceContext->CreateSolidColorBrush(ColorF(rgb), &solidColorBrush));
-
-			m_d2dDeviceContext->DrawTextW(text, lstrlenW(text), dWriteTextFormat.Get(), RectF(0, positionY, deviceContextSize.width, positionY + fontSize), solidColorBrush.Get());
-		};
-
-		RenderText(to_wstring(m_score).c_str(), 0.08f, 0.1f, 0x0063b1);
-
-		if (m_state == State::Over) {
-			RenderText(L"Game Over", 0.1f, 0.4f, 0xea005e);
-
-			RenderText(L"Press any key to restart.", 0.04f, 0.6f, ColorF::Teal);
-		}
+		m_renderer.EndFrame();
 	}
 };
 
-D2DApp::D2DApp(const shared_ptr<WindowModeHelper>& windowModeHelper) : m_impl(make_unique<Impl>(windowModeHelper)) {}
+D2DApp::D2DApp(const shared_ptr<WindowModeHelper>& windowModeHelper, optional<uint32_t> seed, bool isSimulationThreaded, uint32_t tickRate, const filesystem::path& eventLogPath) : m_impl(make_unique<Impl>(windowModeHelper, seed, isSimulationThreaded, tickRate, eventLogPath)) {}
 
 D2DApp::~D2DApp() = default;
 
@@ -462,6 +329,8 @@ SIZE D2DApp::GetOutputSize() const noexcept { return m_impl->GetOutputSize(); }
 
 void D2DApp::Tick() { m_impl->Tick(); }
 
+bool D2DApp::IsIdle() const noexcept { return m_impl->IsIdle(); }
+
 void D2DApp::OnWindowSizeChanged() { m_impl->OnWindowSizeChanged(); }
 
 void D2DApp::OnResuming() { m_impl->OnResuming(); }
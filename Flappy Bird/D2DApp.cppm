@@ -1,7 +1,9 @@
 module;
 #include <Windows.h>
 
+#include <filesystem>
 #include <memory>
+#include <optional>
 
 export module D2DApp;
 
@@ -10,13 +12,19 @@ import WindowHelpers;
 using namespace WindowHelpers;
 
 export struct D2DApp {
-	D2DApp(const std::shared_ptr<WindowModeHelper>& windowModeHelper) noexcept(false);
+	// The game ticks at a fixed tickRate Hz and Tick draws between the last two ticks. A seed switches to deterministic
+	// mode with a reproducible course. A threaded simulation ticks on its own thread, and Tick only draws what it published.
+	// Game events are logged to eventLogPath, replacing the file, if it is not empty.
+	D2DApp(const std::shared_ptr<WindowModeHelper>& windowModeHelper, std::optional<uint32_t> seed = std::nullopt, bool isSimulationThreaded = false, uint32_t tickRate = 60, const std::filesystem::path& eventLogPath = {}) noexcept(false);
 	~D2DApp();
 
 	SIZE GetOutputSize() const noexcept;
 
 	void Tick();
 
+	// Whether nothing on screen needs drawing at the full frame rate: the game has not started or is over.
+	bool IsIdle() const noexcept;
+
 	void OnWindowSizeChanged();
 
 	void OnResuming();
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include "RenderResourceCache.h"
+
+#include "GradientGenerator.h"
+
+#include "LruCache.h"
+
+#include "Debouncer.h"
+
+#include "DurationSamples.h"
+
+class D2DRenderer : public IRenderer {
+public:
+	D2DRenderer() = default;
+
+	D2DRenderer(ID2D1DeviceContext* pDeviceContext, IDWriteFactory* pDWriteFactory) : m_deviceContext(pDeviceContext), m_resourceCache(Resources{ pDeviceContext, pDWriteFactory }) {
+		// Sprite batches need Windows 10; without them batched fills fall back to one fill per sprite.
+		if (SUCCEEDED(m_deviceContext.As(&m_deviceContext3))) DX::ThrowIfFailed(m_deviceContext3->CreateSpriteBatch(&m_spriteBatch));
+	}
+
+	// Gradients are rebaked once the size has settled; until then the previous ones are stretched to fit.
+	void CreateWindowSizeDependentResources() {
+		m_resourceCache.Invalidate();
+
+		if (m_images.Background) m_resizeDebouncer.Notify(Debouncer::Clock::now());
+		else RebuildImages();
+	}
+
+	const auto& GetResourceStatistics() const noexcept { return m_resourceCache.GetStatistics(); }
+
+	const auto& GetGradientStatistics() const noexcept { return m_gradients.GetStatistics(); }
+
+	DurationSamples::Statistics GetBakeStatistics() const { return m_bakeDurations.GetStatistics(); }
+
+	b2Vec2 GetSize() const override {
+		const auto size = m_deviceContext->GetSize();
+		return { size.width, size.height };
+	}
+
+	void BeginFrame() override {
+		if (m_resizeDebouncer.Poll(Debouncer::Clock::now())) RebuildImages();
+
+		m_deviceContext->BeginDraw();
+		m_deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+	}
+
+	void EndFrame() override {
+		m_resourceCache.EndFrame();
+
+		TRACE_ZONE("EndDraw");
+
+		DX::ThrowIfFailed(m_deviceContext->EndDraw());
+	}
+
+	void DrawBackground() override {
+		const auto size = m_deviceContext->GetSize();
+		FillRectangle(Brush::Background, Matrix3x2::Scale(size.width, size.height));
+	}
+
+	void FillRectangle(Brush brush, const Matrix3x2& transform) override {
+		m_deviceContext->SetTransform(ToD2D(transform));
+		m_deviceContext->FillRectangle({ 0, 0, 1, 1 }, GetBrush(brush));
+		m_deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+	}
+
+	void FillEllipse(Brush brush, const Matrix3x2& transform) override {
+		m_deviceContext->SetTransform(ToD2D(transform));
+		m_deviceContext->FillEllipse({ { 0.5f, 0.5f }, 0.5f, 0.5f }, GetBrush(brush));
+		m_deviceContext->SetTransform(D2D1::Matrix3x2F::Identity());
+	}
+
+	void FillRectangles(Brush brush, std::span<const Matrix3x2> transforms) override {
+		if (brush == Brush::Barrier && m_spriteBatch) DrawSprites(m_images.BarrierSprite.Get(), transforms);
+		else IRenderer::FillRectangles(brush, transforms);
+	}
+
+	void FillEllipses(Brush brush, std::span<const Matrix3x2> transforms) override {
+		if (brush == Brush::Pawn && m_spriteBatch) DrawSprites(m_images.PawnSprite.Get(), transforms);
+		else IRenderer::FillEllipses(brush, transforms);
+	}
+
+	void RenderText(std::string_view text, float fontSize, float top, uint32_t rgb) override {
+		const auto& textLayout = m_resourceCache.GetTextLayout(text, "Comic Sans MS", fontSize, m_deviceContext->GetSize().width, fontSize);
+		m_deviceContext->DrawTextLayout({ 0, top }, textLayout.Get(), m_resourceCache.GetSolidBrush(rgb).Get());
+	}
+
+private:
+	Microsoft::WRL::ComPtr<ID2D1DeviceContext> m_deviceContext;
+
+	Microsoft::WRL::ComPtr<ID2D1DeviceContext3> m_deviceContext3;
+	Microsoft::WRL::ComPtr<ID2D1SpriteBatch> m_spriteBatch;
+
+	struct Resources {
+		using TextFormat = Microsoft::WRL::ComPtr<IDWriteTextFormat>;
+		using SolidBrush = Microsoft::WRL::ComPtr<ID2D1SolidColorBrush>;
+		using TextLayout = Microsoft::WRL::ComPtr<IDWriteTextLayout>;
+
+		Microsoft::WRL::ComPtr<ID2D1DeviceContext> DeviceContext;
+		Microsoft::WRL::ComPtr<IDWriteFactory> DWriteFactory;
+
+		TextFormat CreateTextFormat(std::string_view fontFamily, float fontSize) {
+			using DX::ThrowIfFailed;
+
+			TextFormat textFormat;
+			ThrowIfFailed(DWriteFactory->CreateTextFormat(std::wstring(fontFamily.begin(), fontFamily.end()).c_str(), nullptr, DWRITE_FONT_WEIGHT_NORMAL, DWRITE_FONT_STYLE_NORMAL, DWRITE_FONT_STRETCH_NORMAL, fontSize, L"", &textFormat));
+			ThrowIfFailed(textFormat->SetParagraphAlignment(DWRITE_PARAGRAPH_ALIGNMENT_CENTER));
+			ThrowIfFailed(textFormat->SetTextAlignment(DWRITE_TEXT_ALIGNMENT_CENTER));
+			return textFormat;
+		}
+
+		SolidBrush CreateSolidBrush(uint32_t rgb) {
+			SolidBrush solidBrush;
+			DX::ThrowIfFailed(DeviceContext->CreateSolidColorBrush(D2D1::ColorF(rgb), &solidBrush));
+			return solidBrush;
+		}
+
+		TextLayout CreateTextLayout(std::string_view text, const TextFormat& textFormat, float maxWidth, float maxHeight) {
+			const std::wstring wideText(text.begin(), text.end());
+
+			TextLayout textLayout;
+			DX::ThrowIfFailed(DWriteFactory->CreateTextLayout(wideText.c_str(), static_cast<UINT32>(wideText.size()), textFormat.Get(), maxWidth, maxHeight, &textLayout));
+			return textLayout;
+		}
+	};
+	RenderResourceCache<Resources> m_resourceCache;
+
+	struct Images {
+		// Each maps the unit square being filled to its whole bitmap.
+		Microsoft::WRL::ComPtr<ID2D1ImageBrush> Background, Pawn, Barrier;
+
+		// The pawn and barrier brushes filling their shape, for sprite batches, which draw bitmaps.
+		Microsoft::WRL::ComPtr<ID2D1Bitmap> PawnSprite, BarrierSprite;
+	};
+	Images m_images;
+
+	struct GradientKey {
+		::Brush Brush;
+		bool IsEllipse;
+		uint32_t Width, Height;
+
+		bool operator==(const GradientKey&) const = default;
+	};
+
+	// Four bitmaps per output size, so switching between two sizes, as toggling full screen does, bakes nothing.
+	LruCache<GradientKey, Microsoft::WRL::ComPtr<ID2D1Bitmap>> m_gradients{ 8 };
+
+	std::vector<uint32_t> m_gradientPixels;
+
+	Debouncer m_resizeDebouncer{ std::chrono::milliseconds(100) };
+
+	DurationSamples m_bakeDurations;
+
+	void RebuildImages() {
+		using namespace D2D1;
+		using DX::ThrowIfFailed;
+
+		TRACE_ZONE("BakeGradients");
+
+		const auto startTime = std::chrono::steady_clock::now();
+
+		float dpiX, dpiY;
+		m_deviceContext->GetDpi(&dpiX, &dpiY);
+
+		const auto GetBitmap = [&](Brush brush, bool isEllipse, D2D1_SIZE_U size) {
+			return m_gradients.GetOrCreate({ brush, isEllipse, size.width, size.height }, [&] {
+				const auto stride = (size.width + Simd::Width - 1) / Simd::Width * Simd::Width;
+				m_gradientPixels.resize(stride * size.height);
+				GenerateGradient(GetGradient(brush), size.width, size.height, isEllipse, true, m_gradientPixels.data(), stride);
+
+				Microsoft::WRL::ComPtr<ID2D1Bitmap> bitmap;
+				ThrowIfFailed(m_deviceContext->CreateBitmap(size, m_gradientPixels.data(), static_cast<UINT32>(stride * sizeof(uint32_t)), BitmapProperties(PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED), dpiX, dpiY), &bitmap));
+				return bitmap;
+			});
+		};
+
+		const auto CreateImageBrush = [&](ID2D1Bitmap* pBitmap, ID2D1ImageBrush** ppBrush) {
+			const auto size = pBitmap->GetSize();
+			ThrowIfFailed(m_deviceContext->CreateImageBrush(pBitmap, ImageBrushProperties({ 0, 0, size.width, size.height }), BrushProperties(1, Matrix3x2F::Scale(1 / size.width, 1 / size.height)), ppBrush));
+		};
+
+		const auto pixelSize = m_deviceContext->GetPixelSize();
+		const D2D1_SIZE_U
+			backgroundSize{ std::max(pixelSize.width, 1u), std::max(pixelSize.height, 1u) },
+			spriteSize{ std::max(pixelSize.width / 10, 1u), std::max(pixelSize.height / 10, 1u) };
+
+		Images images;
+
+		CreateImageBrush(GetBitmap(Brush::Background, false, backgroundSize).Get(), &images.Background);
+
+		CreateImageBrush(GetBitmap(Brush::Pawn, false, spriteSize).Get(), &images.Pawn);
+
+		images.BarrierSprite = GetBitmap(Brush::Barrier, false, spriteSize);
+		CreateImageBrush(images.BarrierSprite.Get(), &images.Barrier);
+
+		images.PawnSprite = GetBitmap(Brush::Pawn, true, spriteSize);
+
+		m_images = std::move(images);
+
+		m_bakeDurations.Record(std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+	}
+
+	ID2D1Brush* GetBrush(Brush brush) const noexcept {
+		switch (brush) {
+		case Brush::Pawn: return m_images.Pawn.Get();
+		case Brush::Barrier: return m_images.Barrier.Get();
+		default: return m_images.Background.Get();
+		}
+	}
+
+	// Every sprite maps the unit square through its transform, like FillRectangle, and samples the whole bitmap.
+	void DrawSprites(ID2D1Bitmap* pBitmap, std::span<const Matrix3x2> transforms) {
+		static_assert(sizeof(Matrix3x2) == sizeof(D2D1_MATRIX_3X2_F));
+
+		constexpr D2D1_RECT_F UnitSquare{ 0, 0, 1, 1 };
+
+		m_spriteBatch->Clear();
+		DX::ThrowIfFailed(m_spriteBatch->AddSprites(static_cast<UINT32>(transforms.size()), &UnitSquare, nullptr, nullptr, reinterpret_cast<const D2D1_MATRIX_3X2_F*>(transforms.data()), 0, 0, 0, sizeof(D2D1_MATRIX_3X2_F)));
+
+		// Sprite batches are only drawn without antialiasing; the pawn's edge is antialiased in its bitmap.
+		const auto antialiasMode = m_deviceContext3->GetAntialiasMode();
+		m_deviceContext3->SetAntialiasMode(D2D1_ANTIALIAS_MODE_ALIASED);
+		m_deviceContext3->DrawSpriteBatch(m_spriteBatch.Get(), pBitmap, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, D2D1_SPRITE_OPTIONS_NONE);
+		m_deviceContext3->SetAntialiasMode(antialiasMode);
+	}
+
+	static D2D1::Matrix3x2F ToD2D(const Matrix3x2& value) noexcept { return D2D1::Matrix3x2F(value.M11, value.M12, value.M21, value.M22, value.Dx, value.Dy); }
+};
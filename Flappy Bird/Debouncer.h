@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+
+// Turns a burst of changes into a single notification once none has arrived for the delay. Times are passed in so
+// that callers decide the clock.
+class Debouncer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	explicit Debouncer(Clock::duration delay) noexcept : m_delay(delay) {}
+
+	void Notify(Clock::time_point time) noexcept {
+		m_lastTime = time;
+		m_isPending = true;
+	}
+
+	bool IsPending() const noexcept { return m_isPending; }
+
+	// Returns true once per burst, at the first poll that comes at least the delay after its last change.
+	bool Poll(Clock::time_point time) noexcept {
+		if (!m_isPending || time - m_lastTime < m_delay) return false;
+
+		m_isPending = false;
+		return true;
+	}
+
+private:
+	Clock::duration m_delay;
+
+	Clock::time_point m_lastTime;
+
+	bool m_isPending{};
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Game.h"
+
+#include <future>
+#include <optional>
+#include <vector>
+
+// Everything needed to reproduce a run: the seed, the world and fixed tick size, and whether the player pressed
+// before each tick. A press restarts a game that is over and flies the pawn up otherwise, as in D2DApp.
+struct InputTrace {
+	uint32_t Seed{};
+	float WorldWidth = 12 * 16 / 9.0f;
+	float StepSeconds = 1 / 60.0f;
+	std::vector<uint8_t> Presses;
+};
+
+// Records the presses of a policy over tickCount ticks of the course that the seed, world width and tick size of trace
+// describe. It presses whenever the game is not Running, so the game starts at once and restarts whenever it dies.
+template <typename TGame = Game, typename TPolicy>
+InputTrace RecordTrace(const TPolicy& policy, uint32_t tickCount, InputTrace trace = {}) {
+	TGame game(trace.WorldWidth, trace.Seed);
+
+	trace.Presses.clear();
+	trace.Presses.reserve(tickCount);
+	for (uint32_t tick = 0; tick < tickCount; tick++) {
+		const auto isPressed = game.GetState() != TGame::State::Running || policy(game);
+		trace.Presses.emplace_back(isPressed);
+		if (isPressed) {
+			if (game.GetState() == TGame::State::Over) game.Reset();
+			else game.FlyUp();
+		}
+		game.Update(trace.StepSeconds);
+	}
+
+	return trace;
+}
+
+struct Divergence {
+	uint32_t Tick;
+	uint64_t ExpectedHash, ActualHash;
+};
+
+// Replays a trace and returns a hash chain with one entry per tick, each folding in the previous entry and the full
+// state after that tick, so equal entries mean the runs agreed on every tick so far.
+template <typename TGame = Game>
+std::vector<uint64_t> SimulateTrace(const InputTrace& trace) {
+	TGame game(trace.WorldWidth, trace.Seed);
+
+	std::vector<uint64_t> hashes;
+	hashes.reserve(trace.Presses.size());
+
+	uint64_t hash = StateHash::OffsetBasis;
+	for (const auto isPressed : trace.Presses) {
+		if (isPressed) {
+			if (game.GetState() == TGame::State::Over) game.Reset();
+			else game.FlyUp();
+		}
+
+		game.Update(trace.StepSeconds);
+
+		hash = StateHash(hash).Add(game.GetStateHash()).Get();
+		hashes.emplace_back(hash);
+	}
+
+	return hashes;
+}
+
+inline std::optional<Divergence> FindDivergence(const std::vector<uint64_t>& expected, const std::vector<uint64_t>& actual) {
+	for (size_t i = 0; i < expected.size() && i < actual.size(); i++) {
+		if (expected[i] != actual[i]) return Divergence{ static_cast<uint32_t>(i), expected[i], actual[i] };
+	}
+	return std::nullopt;
+}
+
+// Runs the trace twice, back to back or concurrently on two threads, and reports the first tick where they disagree.
+template <typename TGame = Game>
+std::optional<Divergence> VerifyDeterminism(const InputTrace& trace, bool isConcurrent = false) {
+	if (isConcurrent) {
+		auto expected = std::async(std::launch::async, [&] { return SimulateTrace<TGame>(trace); });
+		const auto actual = SimulateTrace<TGame>(trace);
+		return FindDivergence(expected.get(), actual);
+	}
+
+	const auto expected = SimulateTrace<TGame>(trace);
+	return FindDivergence(expected, SimulateTrace<TGame>(trace));
+}
+
+// Snapshots the run of trace at restoreTick, restores that into a game which has played the trace up to elsewhereTick
+// instead, and reports the first of the next tickCount ticks, counted from the start of the trace, where the two
+// disagree on GetStateHash.
+template <typename TGame = Game>
+std::optional<Divergence> VerifyRestore(const InputTrace& trace, uint32_t restoreTick, uint32_t elsewhereTick, uint32_t tickCount) {
+	const auto Play = [&](TGame& game, uint32_t tick) {
+		if (trace.Presses[tick]) {
+			if (game.GetState() == TGame::State::Over) game.Reset();
+			else game.FlyUp();
+		}
+
+		game.Update(trace.StepSeconds);
+	};
+
+	TGame expected(trace.WorldWidth, trace.Seed), actual(trace.WorldWidth, trace.Seed);
+	for (uint32_t tick = 0; tick < restoreTick; tick++) Play(expected, tick);
+	for (uint32_t tick = 0; tick < elsewhereTick; tick++) Play(actual, tick);
+
+	typename TGame::SavedState state;
+	expected.Snapshot(state);
+	actual.Restore(state);
+
+	for (auto tick = restoreTick; tick < restoreTick + tickCount && tick < trace.Presses.size(); tick++) {
+		Play(expected, tick);
+		Play(actual, tick);
+
+		if (const auto expectedHash = expected.GetStateHash(), actualHash = actual.GetStateHash(); expectedHash != actualHash) return Divergence{ tick, expectedHash, actualHash };
+	}
+	return std::nullopt;
+}
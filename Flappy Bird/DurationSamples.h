@@ -0,0 +1,43 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// The most recent Capacity durations, in seconds, and their nearest-rank statistics in microseconds.
+class DurationSamples {
+public:
+	struct Statistics {
+		size_t Count;
+		double MeanMicroseconds, P99Microseconds, MaxMicroseconds;
+	};
+
+	static constexpr size_t Capacity = 1 << 16;
+
+	void Record(double seconds) {
+		if (m_samples.size() < Capacity) m_samples.emplace_back(static_cast<float>(seconds));
+		else m_samples[m_count % Capacity] = static_cast<float>(seconds);
+		m_count++;
+	}
+
+	Statistics GetStatistics() const {
+		if (m_samples.empty()) return {};
+
+		auto samples = m_samples;
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0;
+		for (const auto sample : samples) sum += sample;
+
+		return {
+			samples.size(),
+			sum / samples.size() * 1e6,
+			samples[static_cast<size_t>(0.99 * (samples.size() - 1) + 0.5)] * 1e6,
+			samples.back() * 1e6
+		};
+	}
+
+private:
+	size_t m_count{};
+
+	std::vector<float> m_samples;
+};
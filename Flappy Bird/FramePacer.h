@@ -0,0 +1,79 @@
+#pragma once
+
+#include "StepTimer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+// Decides when the main loop draws: a frame every frame interval while the game is active, one every idle interval
+// while it is idle, and one at once on waking. Idle pacing only starts an idle interval after the last wake, so that
+// input is drawn at the full rate until the game has caught up with it. A frame interval of 0 draws whenever asked.
+// It reads one of the StepTimer clocks and leaves the waiting to the caller, so a VirtualClock can drive it anywhere.
+template <typename TClock>
+class BasicFramePacer {
+public:
+	explicit BasicFramePacer(double frameSeconds, double idleFrameSeconds = 0.1, TClock clock = {}) noexcept(false) :
+		m_clock(clock),
+		m_frequency(m_clock.GetFrequency()),
+		m_frameInterval(SecondsToCounts(frameSeconds)), m_idleFrameInterval(SecondsToCounts(std::max(idleFrameSeconds, frameSeconds))),
+		m_nextFrameTime(m_clock.GetCounter()), m_lastWakeTime(m_nextFrameTime) {}
+
+	TClock& GetClock() noexcept { return m_clock; }
+
+	bool IsIdle() const noexcept { return m_isIdle; }
+
+	// Leaving idle brings the next frame forward to a frame interval after the last one.
+	void SetIdle(bool value) noexcept {
+		if (m_isIdle && !value) m_nextFrameTime = std::min(m_nextFrameTime, m_lastFrameTime + m_frameInterval);
+
+		m_isIdle = value;
+	}
+
+	void Wake() {
+		m_lastWakeTime = m_clock.GetCounter();
+
+		m_nextFrameTime = std::min(m_nextFrameTime, m_lastWakeTime);
+	}
+
+	// 0 once the next frame is due.
+	double GetSecondsUntilNextFrame() const {
+		const auto time = m_clock.GetCounter();
+		return time < m_nextFrameTime ? static_cast<double>(m_nextFrameTime - time) / static_cast<double>(m_frequency) : 0;
+	}
+
+	// Whether a frame is due, in which case the next one is scheduled an interval after it was due, or an interval from
+	// now for a loop that fell more than an interval behind.
+	bool TryBeginFrame() {
+		const auto time = m_clock.GetCounter();
+		if (time < m_nextFrameTime) return false;
+
+		const auto interval = m_isIdle && time - m_lastWakeTime >= m_idleFrameInterval ? m_idleFrameInterval : m_frameInterval;
+		m_nextFrameTime = time - m_nextFrameTime > interval ? time + interval : m_nextFrameTime + interval;
+
+		m_lastFrameTime = time;
+		m_frameCount++;
+
+		return true;
+	}
+
+	uint64_t GetFrameCount() const noexcept { return m_frameCount; }
+
+private:
+	TClock m_clock;
+
+	uint64_t m_frequency;
+	uint64_t m_frameInterval, m_idleFrameInterval;
+
+	uint64_t m_nextFrameTime, m_lastWakeTime, m_lastFrameTime{};
+	uint64_t m_frameCount{};
+
+	bool m_isIdle{};
+
+	uint64_t SecondsToCounts(double seconds) const noexcept { return static_cast<uint64_t>(seconds * static_cast<double>(m_frequency)); }
+};
+
+#ifdef _WIN32
+using FramePacer = BasicFramePacer<DX::QpcClock>;
+#else
+using FramePacer = BasicFramePacer<DX::SteadyClock>;
+#endif
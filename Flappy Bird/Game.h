@@ -0,0 +1,318 @@
+#pragma once
+
+#include "Box2DPhysics.h"
+#include "AnalyticPhysics.h"
+
+#include "Random.h"
+
+#include "StateHash.h"
+
+#include "GameEvents.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+// Game rules on top of a physics policy such as Box2DPhysics or AnalyticPhysics.
+template <typename TPhysics>
+struct BasicGame {
+	using Physics = TPhysics;
+
+	enum class State { NotStarted, Running, Over };
+
+	static constexpr float PawnRadius = 0.5f;
+
+	static constexpr float BarrierWidth = PawnRadius * 2 * 1.7f, BarrierDistance = 5;
+
+	// Barriers a world that wide holds at once, counting the one added just before the front one is removed. It must not
+	// exceed TPhysics::MaxBarrierCount.
+	static size_t GetRequiredBarrierCapacity(float worldWidth) noexcept { return GetInitialBarrierCount(worldWidth) + 1; }
+
+	BasicGame(float worldWidth = 0) {
+		m_worldSize.x = worldWidth;
+
+		InitializeWorld();
+	}
+
+	BasicGame(float worldWidth, uint32_t seed) : m_random(seed) {
+		m_worldSize.x = worldWidth;
+
+		InitializeWorld();
+	}
+
+	// Everything needed to resume a game, as plain data that can be copied with memcpy.
+	struct SavedState {
+		typename TPhysics::SavedState Physics;
+		b2Vec2 WorldSize;
+		BasicGame::State State;
+		uint32_t Score, TickCount;
+		float TotalSeconds;
+		::Random Random;
+	};
+
+	BasicGame(const BasicGame&) = delete;
+	BasicGame& operator=(const BasicGame&) = delete;
+
+	const TPhysics& GetPhysics() const noexcept { return m_physics; }
+
+	// Flaps, barriers, scores, deaths and resets are pushed to queue, if any, from the thread that updates the game.
+	void SetEventQueue(GameEventQueue* queue) noexcept { m_eventQueue = queue; }
+
+	b2Vec2 GetWorldSize() const noexcept { return m_worldSize; }
+
+	b2Vec2 GetPawnPosition() const { return m_physics.GetPawnPosition(); }
+
+	b2Vec2 GetPawnLinearVelocity() const { return m_physics.GetPawnLinearVelocity(); }
+
+	State GetState() const noexcept { return m_state; }
+
+	uint32_t GetScore() const noexcept { return m_score; }
+
+	// Barriers are numbered in the order they are added since the last seed, across resets without one, and the
+	// geometry of each depends only on the seed and that number.
+	float GetCourseGapBottom(uint64_t barrierIndex) const noexcept { return GetBottomHalfHeight(m_random.FloatAt(barrierIndex, 0.3f, 0.5f)) * 2; }
+
+	// Number of Update calls since the last Reset.
+	uint32_t GetTickCount() const noexcept { return m_tickCount; }
+
+	// How far the course scrolled left during the last Update call, for drawing it between ticks.
+	float GetTickScrollX() const noexcept { return m_tickScrollX; }
+
+	// Hash of everything that determines how the game evolves.
+	uint64_t GetStateHash() const {
+		StateHash hash;
+		hash.Add(m_worldSize.x).Add(m_worldSize.y).Add(m_state).Add(m_score).Add(m_tickCount).Add(m_totalSeconds);
+		hash.Add(m_random.GetKey()).Add(m_random.GetPosition());
+
+		const auto position = m_physics.GetPawnPosition(), linearVelocity = m_physics.GetPawnLinearVelocity(), gravity = m_physics.GetGravity();
+		hash.Add(position.x).Add(position.y).Add(m_physics.GetPawnAngle());
+		hash.Add(linearVelocity.x).Add(linearVelocity.y).Add(m_physics.GetPawnAngularVelocity());
+		hash.Add(gravity.x).Add(gravity.y);
+
+		for (size_t i = 0; i < m_physics.GetBarrierCount(); i++) {
+			const auto barrier = m_physics.GetBarrier(i);
+			hash.Add(barrier.PositionX).Add(barrier.HalfWidth).Add(barrier.GapBottom).Add(barrier.GapTop).Add(barrier.Top);
+		}
+
+		return hash.Get();
+	}
+
+	void SetWorldWidth(float value) {
+		m_physics.ShiftOrigin({ (m_worldSize.x - value) / 2, 0 });
+
+		m_worldSize.x = value;
+	}
+
+	void Update(float elapsedSeconds) {
+		m_tickCount++;
+
+		m_tickScrollX = 0;
+
+		Advance(elapsedSeconds);
+	}
+
+	// One tick that flies up at each of flyUpOffsets, ascending seconds from the start of the tick, by splitting the
+	// step there. Without offsets it is the same as Update(elapsedSeconds).
+	void Update(float elapsedSeconds, std::span<const float> flyUpOffsets) {
+		m_tickCount++;
+
+		m_tickScrollX = 0;
+
+		auto advancedSeconds = 0.0f;
+		for (const auto offset : flyUpOffsets) {
+			if (const auto seconds = std::min(offset, elapsedSeconds) - advancedSeconds; seconds > 0) {
+				Advance(seconds);
+				advancedSeconds += seconds;
+			}
+
+			FlyUp();
+		}
+
+		if (advancedSeconds < elapsedSeconds || flyUpOffsets.empty()) Advance(elapsedSeconds - advancedSeconds);
+	}
+
+	void FlyUp() {
+		switch (m_state) {
+		case State::NotStarted: {
+			m_physics.SetGravity({ 0, -10 });
+
+			for (auto count = GetInitialBarrierCount(m_worldSize.x); count; count--) AddBarrier();
+
+			m_state = State::Running;
+		} [[fallthrough]];
+
+		case State::Running: {
+			const auto x = PawnRadius * 2 * 1.7f, g = -m_physics.GetGravity().y, t = std::sqrt(2 * x / g);
+			m_physics.SetPawnLinearVelocity({ m_physics.GetPawnLinearVelocity().x, g * t });
+
+			LogPawnEvent(GameEventType::Flap);
+		} break;
+
+		case State::Over: break;
+		}
+	}
+
+	void Reset() {
+		m_state = {};
+
+		m_score = {};
+
+		m_tickCount = {};
+
+		m_tickScrollX = {};
+
+		m_totalSeconds = {};
+
+		m_physics.Clear();
+
+		InitializeWorld();
+
+		LogPawnEvent(GameEventType::Reset);
+	}
+
+	void Snapshot(SavedState& state) const {
+		static_assert(std::is_trivially_copyable_v<SavedState>);
+
+		m_physics.Save(state.Physics);
+		state.WorldSize = m_worldSize;
+		state.State = m_state;
+		state.Score = m_score;
+		state.TickCount = m_tickCount;
+		state.TotalSeconds = m_totalSeconds;
+		state.Random = m_random;
+	}
+
+	// Whether Restore can take state, which a corrupt file may not satisfy.
+	static bool CanRestore(const SavedState& state) noexcept { return TPhysics::CanRestore(state.Physics) && state.State <= State::Over; }
+
+	void Restore(const SavedState& state) {
+		m_physics.Restore(state.Physics);
+		m_worldSize = state.WorldSize;
+		m_state = state.State;
+		m_score = state.Score;
+		m_tickCount = state.TickCount;
+		m_tickScrollX = {};
+		m_totalSeconds = state.TotalSeconds;
+		m_random = state.Random;
+	}
+
+	void Reset(uint32_t seed) {
+		m_random.Seed(seed);
+
+		Reset();
+	}
+
+private:
+	b2Vec2 m_worldSize{ 0, 12 };
+
+	TPhysics m_physics;
+
+	State m_state{};
+
+	uint32_t m_score{};
+
+	uint32_t m_tickCount{};
+
+	float m_tickScrollX{};
+
+	float m_totalSeconds{};
+
+	Random m_random;
+
+	GameEventQueue* m_eventQueue{};
+
+	void LogEvent(GameEventType type, float x, float y, uint16_t count = 0) noexcept {
+		if (m_eventQueue != nullptr) m_eventQueue->Push({ m_tickCount, type, 0, count, x, y });
+	}
+
+	void LogPawnEvent(GameEventType type, uint16_t count = 0) {
+		if (m_eventQueue == nullptr) return;
+
+		const auto position = m_physics.GetPawnPosition();
+		LogEvent(type, position.x, position.y, count);
+	}
+
+	void LogBarrierEvent(GameEventType type, size_t index) {
+		if (m_eventQueue == nullptr) return;
+
+		const auto barrier = m_physics.GetBarrier(index);
+		LogEvent(type, barrier.PositionX, barrier.GapBottom);
+	}
+
+	void InitializeWorld() {
+		const b2Vec2 groundHalfSize{ 50, 0.1f };
+		m_physics.CreateGround({ m_worldSize.x / 2, -groundHalfSize.y }, groundHalfSize);
+
+		m_physics.CreatePawn({ m_worldSize.x / 2 - PawnRadius, m_worldSize.y / 2 }, { 2, 0 }, PawnRadius);
+	}
+
+	void Advance(float elapsedSeconds) {
+		m_totalSeconds += elapsedSeconds;
+
+		if (m_state == State::NotStarted) {
+			constexpr auto CalculateSpringOscillatorVelocity = [](float a, float ω, float t, float φ) { return -a * ω * std::sin(ω * t - φ); };
+
+			auto v = m_physics.GetPawnLinearVelocity();
+			v.y = CalculateSpringOscillatorVelocity(0.1f, 2 * b2_pi / 0.8f, m_totalSeconds, 0);
+			m_physics.SetPawnLinearVelocity(v);
+		}
+
+		const auto pawnPositionX = m_physics.GetPawnPosition().x;
+
+		const auto contacts = m_physics.Step(elapsedSeconds);
+
+		if (m_state == State::Running && contacts.GapsCleared) {
+			m_score += contacts.GapsCleared;
+
+			LogPawnEvent(GameEventType::Score, static_cast<uint16_t>(contacts.GapsCleared));
+		}
+
+		if (contacts.IsHit && m_state != State::Over) {
+			m_state = State::Over;
+
+			LogPawnEvent(GameEventType::Death);
+		}
+
+		const auto pawnDisplacementX = m_physics.GetPawnPosition().x - pawnPositionX;
+
+		m_physics.MoveGround(pawnDisplacementX);
+
+		m_physics.ShiftOrigin({ pawnDisplacementX, 0 });
+
+		m_tickScrollX += pawnDisplacementX;
+
+		if (m_state == State::Running) {
+			if (m_physics.GetBarrierPositionX(0) - BarrierWidth / 2 + BarrierDistance < 0) {
+				TRACE_ZONE("RecycleBarrier");
+
+				AddBarrier();
+				LogBarrierEvent(GameEventType::BarrierRecycled, 0);
+				m_physics.RemoveFrontBarrier();
+			}
+		}
+	}
+
+	static size_t GetInitialBarrierCount(float worldWidth) noexcept { return static_cast<size_t>(std::ceil((worldWidth + BarrierDistance) / (BarrierDistance + BarrierWidth))); }
+
+	float GetBottomHalfHeight(float fraction) const noexcept { return m_worldSize.y / 2 * fraction; }
+
+	void AddBarrier() {
+		const auto
+			worldHalfHeight = m_worldSize.y / 2,
+			gapHalfHeight = PawnRadius * 2.8f,
+			bottomHalfHeight = GetBottomHalfHeight(m_random.Float(0.3f, 0.5f)), topHalfHeight = worldHalfHeight - gapHalfHeight - bottomHalfHeight;
+
+		const auto barrierCount = m_physics.GetBarrierCount();
+		const auto positionX = barrierCount ? m_physics.GetBarrierPositionX(barrierCount - 1) + BarrierDistance : m_worldSize.x + BarrierWidth / 2 + 1;
+
+		m_physics.AddBarrier(positionX, BarrierWidth / 2, bottomHalfHeight, gapHalfHeight, topHalfHeight);
+
+		LogBarrierEvent(GameEventType::BarrierSpawned, barrierCount);
+	}
+};
+
+using Game = BasicGame<Box2DPhysics>;
+
+using AnalyticGame = BasicGame<AnalyticPhysics>;
@@ -0,0 +1,222 @@
+#pragma once
+
+#include "Game.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <vector>
+
+// Steps many AnalyticGame-equivalent games at once, stored as structure of arrays and advanced Simd::Width lanes at a time.
+// Everything is tracked in the pawn's frame, as the game does by shifting the origin every step: the pawn stays at
+// the spawn x and barriers scroll left. Barriers are always BarrierDistance apart, so a ring only keeps the front
+// barrier x and one gap bottom per barrier. A game scores when the pawn stops overlapping a gap, as AnalyticPhysics'
+// gap sensors do, so flying over a barrier scores nothing. A game that hits something stops moving until it is Reset().
+class GameBatch {
+public:
+	using Rules = AnalyticGame;
+
+	using State = Rules::State;
+
+	static constexpr int32_t MaxBarrierCount = 8;
+
+	// Bytes of lane state per game.
+	static constexpr size_t GameSize = sizeof(float) * (4 + MaxBarrierCount) + sizeof(int32_t) * 5 + sizeof(Random);
+
+	// Game i draws the same course as an AnalyticGame seeded with seed + i.
+	GameBatch(size_t count, uint32_t seed, float worldWidth = 12 * 16 / 9.0f) :
+		m_count(count),
+		m_laneCount((count + Simd::Width - 1) / Simd::Width * Simd::Width),
+		m_pawnPositionX(worldWidth / 2 - Rules::PawnRadius),
+		m_spawnBarrierPositionX(worldWidth + Rules::BarrierWidth / 2 + 1),
+		m_barrierCount(static_cast<int32_t>(std::ceil((worldWidth + Rules::BarrierDistance) / (Rules::BarrierDistance + Rules::BarrierWidth)))),
+		m_pawnPositionY(m_laneCount), m_pawnVelocityY(m_laneCount), m_barrierPositionX(m_laneCount), m_totalSeconds(m_laneCount),
+		m_states(m_laneCount), m_barrierFronts(m_laneCount), m_barriersRemoved(m_laneCount), m_scores(m_laneCount), m_gapBarriers(m_laneCount),
+		m_gapBottoms(m_laneCount * MaxBarrierCount) {
+		if (m_barrierCount > MaxBarrierCount) throw std::invalid_argument("World is too wide");
+
+		m_randoms.reserve(m_laneCount);
+		for (size_t i = 0; i < m_laneCount; i++) {
+			m_randoms.emplace_back(static_cast<uint32_t>(seed + i));
+
+			Reset(i);
+
+			if (i >= m_count) m_states[i] = static_cast<int32_t>(State::Over);
+		}
+	}
+
+	size_t GetCount() const noexcept { return m_count; }
+
+	size_t GetMemoryFootprint() const noexcept { return sizeof(*this) + m_laneCount * GameSize; }
+
+	State GetState(size_t index) const noexcept { return static_cast<State>(m_states[index]); }
+
+	uint32_t GetScore(size_t index) const noexcept { return static_cast<uint32_t>(m_scores[index]); }
+
+	b2Vec2 GetPawnPosition(size_t index) const noexcept { return { m_pawnPositionX, m_pawnPositionY[index] }; }
+
+	float GetPawnVelocityY(size_t index) const noexcept { return m_pawnVelocityY[index]; }
+
+	// Barrier 0 is the front barrier, which may already be behind the pawn.
+	float GetBarrierPositionX(size_t index, int32_t barrier) const noexcept { return m_barrierPositionX[index] + barrier * Rules::BarrierDistance; }
+
+	float GetBarrierGapBottom(size_t index, int32_t barrier) const noexcept { return m_gapBottoms[index * MaxBarrierCount + ((m_barrierFronts[index] + barrier) & (MaxBarrierCount - 1))]; }
+
+	float GetBarrierGapTop(size_t index, int32_t barrier) const noexcept { return GetBarrierGapBottom(index, barrier) + GapHalfHeight * 2; }
+
+	int32_t GetBarrierCount() const noexcept { return m_barrierCount; }
+
+	void Reset(size_t index) noexcept {
+		m_pawnPositionY[index] = WorldHeight / 2;
+		m_pawnVelocityY[index] = 0;
+		m_barrierPositionX[index] = m_spawnBarrierPositionX;
+		m_totalSeconds[index] = 0;
+		m_states[index] = static_cast<int32_t>(State::NotStarted);
+		m_barrierFronts[index] = m_barriersRemoved[index] = m_scores[index] = 0;
+		m_gapBarriers[index] = NoGapBarrier;
+	}
+
+	// Advances every game by one step. A non-zero action flies the pawn up first, exactly like FlyUp() before Update().
+	void Step(const uint8_t* actions, float elapsedSeconds) noexcept {
+		using namespace Simd;
+
+		const auto
+			dt = Broadcast(elapsedSeconds),
+			gravity = Broadcast(Gravity * elapsedSeconds),
+			flyUpVelocity = Broadcast(FlyUpVelocity),
+			scrollDistance = Broadcast(m_pawnPositionX + PawnVelocityX * elapsedSeconds - m_pawnPositionX),
+			pawnPositionX = Broadcast(m_pawnPositionX),
+			reach = Broadcast(Reach),
+			reachSquared = reach * reach,
+			barrierHalfWidth = Broadcast(Rules::BarrierWidth / 2),
+			barrierDistance = Broadcast(Rules::BarrierDistance),
+			gapHeight = Broadcast(GapHalfHeight * 2),
+			worldHeight = Broadcast(WorldHeight),
+			zero = Broadcast(0),
+			one = Broadcast(1),
+			lastBarrier = Broadcast(static_cast<float>(m_barrierCount - 1));
+		const auto
+			notStarted = BroadcastInt(static_cast<int32_t>(State::NotStarted)),
+			running = BroadcastInt(static_cast<int32_t>(State::Running)),
+			over = BroadcastInt(static_cast<int32_t>(State::Over)),
+			noGapBarrier = BroadcastInt(NoGapBarrier),
+			oneInt = BroadcastInt(1),
+			ringMask = BroadcastInt(MaxBarrierCount - 1),
+			ringStride = BroadcastInt(MaxBarrierCount);
+
+		for (size_t i = 0; i < m_laneCount; i += Width) {
+			uint8_t tailActions[Width]{};
+			if (i + Width > m_count) std::copy(actions + i, actions + m_count, tailActions);
+			const auto flyUp = LoadMask(i + Width > m_count ? tailActions : actions + i);
+
+			auto state = Load(&m_states[i]);
+
+			// Starting a game fills its barrier ring, which needs the lane's random stream.
+			if (auto bits = ToBits(flyUp & (state == notStarted)); bits) {
+				for (; bits; bits &= bits - 1) Start(i + std::countr_zero(bits));
+				state = Load(&m_states[i]);
+			}
+
+			const auto isNotStarted = state == notStarted, isRunning = state == running;
+
+			if (const auto bits = ToBits(isNotStarted); bits) Bob(i, bits, elapsedSeconds);
+
+			auto y = Load(&m_pawnPositionY[i]), vy = Load(&m_pawnVelocityY[i]);
+			vy = Select(flyUp & isRunning, flyUpVelocity, vy);
+			vy = Select(isRunning, vy + gravity, vy);
+			y = Select(isRunning | isNotStarted, y + vy * dt, y);
+
+			auto barrierPositionX = Load(&m_barrierPositionX[i]);
+			barrierPositionX = Select(isRunning, barrierPositionX - scrollDistance, barrierPositionX);
+
+			// Barriers the pawn has completely left behind.
+			const auto passed = Max(Floor((pawnPositionX - reach - barrierHalfWidth - barrierPositionX) / barrierDistance) + one, zero);
+
+			const auto barrier = Min(passed, lastBarrier);
+			const auto front = Load(&m_barrierFronts[i]);
+			const auto gapBottom = Gather(m_gapBottoms.data(), (BroadcastInt(static_cast<int32_t>(i)) + Iota()) * ringStride + ((front + ToInt(barrier)) & ringMask));
+			const auto gapTop = gapBottom + gapHeight;
+
+			const auto centerX = barrierPositionX + barrier * barrierDistance;
+			const auto dx = Max(Max(centerX - barrierHalfWidth - pawnPositionX, pawnPositionX - centerX - barrierHalfWidth), zero);
+			const auto dyBottom = Max(y - gapBottom, zero), dyTop = Max(Max(gapTop - y, y - worldHeight), zero);
+			const auto isHit = isRunning & (
+				(dx * dx + dyBottom * dyBottom < reachSquared) |
+				(dx * dx + dyTop * dyTop < reachSquared) |
+				(y < reach));
+
+			// The gap the pawn overlaps, if any, numbered by barriers added since the last Reset. Leaving one scores unless
+			// the pawn hit something on the same step.
+			const auto dyGap = Max(Max(gapBottom - y, y - gapTop), zero);
+			const auto isInGap = isRunning & (dx * dx + dyGap * dyGap < reachSquared);
+			const auto barrierNumber = Load(&m_barriersRemoved[i]) + ToInt(barrier), gapBarrier = Load(&m_gapBarriers[i]);
+			const auto hasLeftGap = AndNot(AndNot(AndNot(isRunning, isHit), gapBarrier == noGapBarrier), (gapBarrier == barrierNumber) & isInGap);
+
+			const auto score = Load(&m_scores[i]);
+			Store(&m_scores[i], Select(hasLeftGap, score + oneInt, score));
+			Store(&m_gapBarriers[i], Select(isInGap, barrierNumber, noGapBarrier));
+
+			Store(&m_states[i], Select(isHit, over, state));
+			Store(&m_pawnPositionY[i], y);
+			Store(&m_pawnVelocityY[i], vy);
+			Store(&m_barrierPositionX[i], barrierPositionX);
+
+			if (auto bits = ToBits(AndNot(isRunning, isHit) & (barrierPositionX - barrierHalfWidth + barrierDistance < zero)); bits) {
+				for (; bits; bits &= bits - 1) RecycleBarrier(i + std::countr_zero(bits));
+			}
+		}
+	}
+
+private:
+	static constexpr float
+		WorldHeight = 12,
+		Gravity = -10,
+		PawnVelocityX = 2,
+		GapHalfHeight = Rules::PawnRadius * 2.8f,
+		Reach = Rules::PawnRadius + AnalyticPhysics::ContactSkin;
+
+	static constexpr int32_t NoGapBarrier = -1;
+
+	static inline const float FlyUpVelocity = -Gravity * std::sqrt(2 * (Rules::PawnRadius * 2 * 1.7f) / -Gravity);
+
+	size_t m_count, m_laneCount;
+
+	float m_pawnPositionX, m_spawnBarrierPositionX;
+
+	int32_t m_barrierCount;
+
+	std::vector<float> m_pawnPositionY, m_pawnVelocityY, m_barrierPositionX, m_totalSeconds;
+
+	std::vector<int32_t> m_states, m_barrierFronts, m_barriersRemoved, m_scores, m_gapBarriers;
+
+	std::vector<float> m_gapBottoms;
+
+	std::vector<Random> m_randoms;
+
+	float NextGapBottom(size_t index) noexcept { return WorldHeight / 2 * m_randoms[index].Float(0.3f, 0.5f) * 2; }
+
+	void Start(size_t index) noexcept {
+		for (int32_t i = 0; i < m_barrierCount; i++) m_gapBottoms[index * MaxBarrierCount + i] = NextGapBottom(index);
+
+		m_states[index] = static_cast<int32_t>(State::Running);
+	}
+
+	void Bob(size_t first, uint32_t bits, float elapsedSeconds) noexcept {
+		constexpr auto ω = 2 * b2_pi / 0.8f;
+
+		for (; bits; bits &= bits - 1) {
+			const auto index = first + std::countr_zero(bits);
+			m_pawnVelocityY[index] = -0.1f * ω * std::sin(ω * (m_totalSeconds[index] += elapsedSeconds));
+		}
+	}
+
+	void RecycleBarrier(size_t index) noexcept {
+		const auto front = m_barrierFronts[index];
+		m_gapBottoms[index * MaxBarrierCount + ((front + m_barrierCount) & (MaxBarrierCount - 1))] = NextGapBottom(index);
+		m_barrierFronts[index] = (front + 1) & (MaxBarrierCount - 1);
+		m_barrierPositionX[index] += Rules::BarrierDistance;
+		m_barriersRemoved[index]++;
+	}
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "GameEvents.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+// The binary log is a header, the magic "FBEV", the version and the record size as 32-bit integers, followed by
+// GameEvent records as they are laid out in memory, little-endian on every platform the game runs on.
+namespace GameEventLog {
+	constexpr char Magic[4]{ 'F', 'B', 'E', 'V' };
+
+	constexpr uint32_t Version = 1;
+
+	inline void WriteHeader(std::ostream& stream) {
+		const uint32_t version = Version, recordSize = sizeof(GameEvent);
+		stream.write(Magic, sizeof(Magic));
+		stream.write(reinterpret_cast<const char*>(&version), sizeof(version));
+		stream.write(reinterpret_cast<const char*>(&recordSize), sizeof(recordSize));
+	}
+
+	inline bool ReadHeader(std::istream& stream) {
+		char magic[sizeof(Magic)];
+		uint32_t version, recordSize;
+		stream.read(magic, sizeof(magic));
+		stream.read(reinterpret_cast<char*>(&version), sizeof(version));
+		stream.read(reinterpret_cast<char*>(&recordSize), sizeof(recordSize));
+		return stream && std::equal(magic, magic + sizeof(magic), Magic) && version == Version && recordSize == sizeof(GameEvent);
+	}
+
+	inline const char* ToString(GameEventType type) noexcept {
+		switch (type) {
+		case GameEventType::Flap: return "Flap";
+		case GameEventType::BarrierSpawned: return "BarrierSpawned";
+		case GameEventType::BarrierRecycled: return "BarrierRecycled";
+		case GameEventType::Score: return "Score";
+		case GameEventType::Death: return "Death";
+		case GameEventType::Reset: return "Reset";
+		case GameEventType::Dropped: return "Dropped";
+		default: return "Unknown";
+		}
+	}
+
+	// One line per event: tick, type, x, y and count. Returns false if the header is not a log this build reads.
+	inline bool ConvertToText(std::istream& binary, std::ostream& text) {
+		if (!ReadHeader(binary)) return false;
+
+		for (GameEvent event; binary.read(reinterpret_cast<char*>(&event), sizeof(event));) {
+			text << event.Tick << ' ' << ToString(event.Type) << ' ' << event.X << ' ' << event.Y << ' ' << event.Count << '\n';
+		}
+		return true;
+	}
+}
+
+// Drains a GameEventQueue into a binary log on a background thread, waking every interval and writing whatever has
+// accumulated in one batch. Events the queue dropped are recorded as a Dropped event. Whatever is left is written when
+// the writer is destroyed, so the game must stop pushing first.
+class GameEventWriter {
+public:
+	GameEventWriter(GameEventQueue& queue, std::ostream& stream, std::chrono::milliseconds interval = std::chrono::milliseconds(50)) :
+		m_queue(queue), m_stream(stream),
+		m_thread([this, interval](std::stop_token stopToken) {
+			m_events.reserve(GameEventQueue::Capacity + 1);
+
+			GameEventLog::WriteHeader(m_stream);
+
+			// Waits on nothing but the stop request, so that destruction does not wait out the interval.
+			std::mutex mutex;
+			std::condition_variable_any stopped;
+			std::unique_lock lock(mutex);
+			while (!stopToken.stop_requested()) {
+				stopped.wait_for(lock, stopToken, interval, [] { return false; });
+				Drain();
+			}
+
+			Drain();
+		}) {}
+
+	GameEventWriter(const GameEventWriter&) = delete;
+	GameEventWriter& operator=(const GameEventWriter&) = delete;
+
+private:
+	GameEventQueue& m_queue;
+	std::ostream& m_stream;
+
+	std::vector<GameEvent> m_events;
+
+	uint64_t m_droppedCount{};
+	uint32_t m_lastTick{};
+
+	std::jthread m_thread;
+
+	void Drain() {
+		m_events.clear();
+		for (GameEvent event; m_queue.TryPop(event);) m_events.emplace_back(event);
+
+		if (!m_events.empty()) m_lastTick = m_events.back().Tick;
+
+		if (const auto droppedCount = m_queue.GetDroppedCount(); droppedCount != m_droppedCount) {
+			const auto count = std::min<uint64_t>(droppedCount - m_droppedCount, UINT16_MAX);
+			m_events.push_back({ m_lastTick, GameEventType::Dropped, 0, static_cast<uint16_t>(count), 0, 0 });
+			m_droppedCount += count;
+		}
+
+		if (m_events.empty()) return;
+
+		m_stream.write(reinterpret_cast<const char*>(m_events.data()), static_cast<std::streamsize>(m_events.size() * sizeof(GameEvent)));
+		m_stream.flush();
+	}
+};
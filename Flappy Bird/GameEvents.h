@@ -0,0 +1,41 @@
+#pragma once
+
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <cstdint>
+
+enum class GameEventType : uint8_t { Flap, BarrierSpawned, BarrierRecycled, Score, Death, Reset, Dropped };
+
+// Positions are in world units when the event happened: the pawn's for flaps, scores, deaths and resets, and the
+// barrier's center x and gap bottom for barrier events. Count is the gaps cleared by a score, the events lost to a
+// full queue for Dropped, and zero otherwise. Tick counts from the episode's last reset.
+struct GameEvent {
+	uint32_t Tick;
+	GameEventType Type;
+	uint8_t Reserved;
+	uint16_t Count;
+	float X, Y;
+};
+
+static_assert(sizeof(GameEvent) == 16);
+
+// The events of one game, pushed by whichever thread runs it and drained by a GameEventWriter. A full queue drops
+// events rather than stall the simulation, and counts them.
+class GameEventQueue {
+public:
+	static constexpr size_t Capacity = 1 << 12;
+
+	void Push(const GameEvent& event) noexcept {
+		if (!m_queue.TryPush(event)) m_droppedCount.store(m_droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	}
+
+	bool TryPop(GameEvent& event) noexcept { return m_queue.TryPop(event); }
+
+	uint64_t GetDroppedCount() const noexcept { return m_droppedCount.load(std::memory_order_relaxed); }
+
+private:
+	SpscQueue<GameEvent, Capacity> m_queue;
+
+	std::atomic<uint64_t> m_droppedCount{};
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+
+// Bakes a LinearGradient spanning the whole image into premultiplied 8-bit pixels, Simd::Width at a time, with the
+// stops interpolated in sRGB as Direct2D does. An ellipse fills the inscribed ellipse with an antialiased edge and
+// leaves the rest transparent. Bgra writes bytes B, G, R, A in memory order, as DXGI_FORMAT_B8G8R8A8_UNORM expects,
+// and otherwise R, G, B, A. stride is in pixels and must be at least width rounded up to Simd::Width.
+inline void GenerateGradient(const LinearGradient& gradient, uint32_t width, uint32_t height, bool isEllipse, bool isBgra, uint32_t* pixels, size_t stride) noexcept {
+	using namespace Simd;
+
+	const auto Channel = [](uint32_t rgb, int shift) { return static_cast<float>(rgb >> shift & 0xff); };
+	const auto redShift = isBgra ? 16 : 0, blueShift = isBgra ? 0 : 16;
+	const Float
+		startR = Broadcast(Channel(gradient.StartRgb, 16)), deltaR = Broadcast(Channel(gradient.EndRgb, 16) - Channel(gradient.StartRgb, 16)),
+		startG = Broadcast(Channel(gradient.StartRgb, 8)), deltaG = Broadcast(Channel(gradient.EndRgb, 8) - Channel(gradient.StartRgb, 8)),
+		startB = Broadcast(Channel(gradient.StartRgb, 0)), deltaB = Broadcast(Channel(gradient.EndRgb, 0) - Channel(gradient.StartRgb, 0));
+
+	const auto gradientScale = 1 / (gradient.End.x * gradient.End.x + gradient.End.y * gradient.End.y);
+	const auto endX = Broadcast(gradient.End.x * gradientScale), endY = Broadcast(gradient.End.y * gradientScale);
+
+	const auto zero = Broadcast(0), one = Broadcast(1), half = Broadcast(0.5f), opaque = Broadcast(255);
+	const auto lane = ToFloat(Iota());
+	const auto du = Broadcast(1.0f / width);
+	const auto red = BroadcastInt(1 << redShift), green = BroadcastInt(1 << 8), blue = BroadcastInt(1 << blueShift), alpha = BroadcastInt(1 << 24);
+
+	// Coverage falls from 1 to 0 across one pixel at the edge, measured along the shorter semi-axis.
+	const auto edgeScale = Broadcast(std::min(width, height) / 2.0f);
+
+	for (uint32_t y = 0; y < height; y++) {
+		const auto row = reinterpret_cast<int32_t*>(pixels + y * stride);
+		const auto v = Broadcast((y + 0.5f) / height);
+
+		for (uint32_t x = 0; x < width; x += static_cast<uint32_t>(Width)) {
+			const auto u = (Broadcast(static_cast<float>(x)) + lane + half) * du;
+
+			const auto t = Min(Max(u * endX + v * endY, zero), one);
+
+			auto coverage = one;
+			if (isEllipse) {
+				const auto cu = (u - half) * Broadcast(2), cv = (v - half) * Broadcast(2);
+				coverage = Min(Max(half - (Sqrt(cu * cu + cv * cv) - one) * edgeScale, zero), one);
+			}
+
+			Store(row + x,
+				ToInt((startR + deltaR * t) * coverage + half) * red +
+				ToInt((startG + deltaG * t) * coverage + half) * green +
+				ToInt((startB + deltaB * t) * coverage + half) * blue +
+				ToInt(opaque * coverage + half) * alpha);
+		}
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "DurationSamples.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <chrono>
+
+// A key or button press, stamped when the window procedure saw it.
+struct InputEvent {
+	std::chrono::steady_clock::time_point Time;
+	bool IsFlyUp;
+};
+
+// Filled by the window thread and drained at tick boundaries by the thread that updates the game.
+using InputQueue = SpscQueue<InputEvent, 256>;
+
+// Measures how long inputs take to reach the game and the screen. The updating thread records each input once the
+// tick that applied it has stepped and marks the earliest of them once that tick's state is published; the rendering
+// thread records it when a frame showing that state has been presented. Inputs applied while another is still
+// waiting to be presented only count towards the step latency.
+class InputLatency {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	void RecordStep(Clock::time_point inputTime, Clock::time_point stepTime) {
+		m_toStep.Record(std::chrono::duration<double>(stepTime - inputTime).count());
+
+		if (m_steppedTime == Clock::time_point{}) m_steppedTime = inputTime;
+	}
+
+	void Publish() noexcept {
+		if (m_steppedTime == Clock::time_point{}) return;
+
+		auto expected = Clock::rep{};
+		m_unpresentedTime.compare_exchange_strong(expected, m_steppedTime.time_since_epoch().count(), std::memory_order_release, std::memory_order_relaxed);
+		m_steppedTime = {};
+	}
+
+	// Call before acquiring the state to present, and pass the result to RecordPresent once it is on screen.
+	Clock::time_point GetUnpresented() const noexcept { return Clock::time_point(Clock::duration(m_unpresentedTime.load(std::memory_order_acquire))); }
+
+	void RecordPresent(Clock::time_point unpresentedTime, Clock::time_point presentTime) {
+		if (unpresentedTime == Clock::time_point{}) return;
+
+		m_toPresent.Record(std::chrono::duration<double>(presentTime - unpresentedTime).count());
+
+		auto expected = unpresentedTime.time_since_epoch().count();
+		m_unpresentedTime.compare_exchange_strong(expected, 0, std::memory_order_relaxed);
+	}
+
+	DurationSamples::Statistics GetStepStatistics() const { return m_toStep.GetStatistics(); }
+
+	DurationSamples::Statistics GetPresentStatistics() const { return m_toPresent.GetStatistics(); }
+
+private:
+	DurationSamples m_toStep, m_toPresent;
+
+	Clock::time_point m_steppedTime;
+
+	std::atomic<Clock::rep> m_unpresentedTime{};
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Keeps at most capacity values, evicting the least recently used. Meant for a handful of entries, so lookups are a
+// linear scan.
+template <typename TKey, typename TValue>
+class LruCache {
+public:
+	struct Statistics {
+		uint64_t Hits, Misses, Evictions;
+	};
+
+	explicit LruCache(size_t capacity) : m_capacity(capacity) { m_entries.reserve(capacity); }
+
+	const Statistics& GetStatistics() const noexcept { return m_statistics; }
+
+	size_t GetSize() const noexcept { return m_entries.size(); }
+
+	template <typename TCreate>
+	TValue GetOrCreate(const TKey& key, TCreate&& create) {
+		m_clock++;
+
+		for (auto& entry : m_entries) {
+			if (entry.Key == key) {
+				m_statistics.Hits++;
+				entry.LastUse = m_clock;
+				return entry.Value;
+			}
+		}
+
+		m_statistics.Misses++;
+
+		auto value = create();
+
+		if (m_entries.size() < m_capacity) m_entries.push_back({ key, value, m_clock });
+		else {
+			auto leastRecentlyUsed = m_entries.begin();
+			for (auto i = m_entries.begin(); i != m_entries.end(); ++i) {
+				if (i->LastUse < leastRecentlyUsed->LastUse) leastRecentlyUsed = i;
+			}
+			*leastRecentlyUsed = { key, value, m_clock };
+			m_statistics.Evictions++;
+		}
+
+		return value;
+	}
+
+	void Clear() {
+		m_statistics.Evictions += m_entries.size();
+		m_entries.clear();
+	}
+
+private:
+	struct Entry {
+		TKey Key;
+		TValue Value;
+		uint64_t LastUse;
+	};
+
+	size_t m_capacity;
+
+	std::vector<Entry> m_entries;
+
+	uint64_t m_clock{};
+
+	Statistics m_statistics{};
+};
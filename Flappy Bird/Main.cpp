@@ -2,7 +2,13 @@
 
 #include "resource.h"
 
+#include "FramePacer.h"
+
+#include <cmath>
+#include <filesystem>
+#include <optional>
 #include <set>
+#include <string_view>
 
 import D2DApp;
 import DisplayHelpers;
@@ -21,9 +27,25 @@ shared_ptr<WindowModeHelper> g_windowModeHelper;
 
 unique_ptr<D2DApp> g_app;
 
+unique_ptr<FramePacer> g_framePacer;
+
+// Sleeps until seconds have passed or a message arrives, on a high-resolution timer where the system has one.
+void WaitForFrameOrMessage(HANDLE timer, double seconds) {
+	if (timer != nullptr) {
+		LARGE_INTEGER dueTime;
+		dueTime.QuadPart = -static_cast<LONGLONG>(seconds * 10000000);
+		if (SetWaitableTimerEx(timer, &dueTime, 0, nullptr, nullptr, nullptr, 0)) {
+			MsgWaitForMultipleObjectsEx(1, &timer, INFINITE, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+			return;
+		}
+	}
+
+	MsgWaitForMultipleObjectsEx(0, nullptr, static_cast<DWORD>(ceil(seconds * 1000)), QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+}
+
 int WINAPI wWinMain(
 	[[maybe_unused]] _In_ HINSTANCE hInstance, _In_opt_ HINSTANCE,
-	[[maybe_unused]] _In_ LPWSTR lpCmdLine, [[maybe_unused]] _In_ int nShowCmd
+	_In_ LPWSTR lpCmdLine, [[maybe_unused]] _In_ int nShowCmd
 ) {
 	int ret;
 	
@@ -60,7 +82,32 @@ int WINAPI wWinMain(
 
 		g_windowModeHelper->SetResolution({ clientRect.right - clientRect.left, clientRect.bottom - clientRect.top });
 
-		g_app = make_unique<decltype(g_app)::element_type>(g_windowModeHelper);
+		optional<uint32_t> seed;
+		if (const auto option = wcsstr(lpCmdLine, L"--seed="); option != nullptr) seed = static_cast<uint32_t>(wcstoul(option + 7, nullptr, 10));
+
+		const auto isSimulationThreaded = wcsstr(lpCmdLine, L"--threaded") != nullptr;
+
+		uint32_t tickRate = 60;
+		if (const auto option = wcsstr(lpCmdLine, L"--tick-rate="); option != nullptr) tickRate = max(static_cast<uint32_t>(wcstoul(option + 12, nullptr, 10)), 1u);
+
+		// Frames are paced to the display unless a rate is given, and 0 draws as fast as presenting allows.
+		double frameRate = 60;
+		if (DEVMODEW mode{ .dmSize = sizeof(mode) }; EnumDisplaySettingsW(nullptr, ENUM_CURRENT_SETTINGS, &mode) && mode.dmDisplayFrequency > 1) frameRate = mode.dmDisplayFrequency;
+		if (const auto option = wcsstr(lpCmdLine, L"--frame-rate="); option != nullptr) frameRate = wcstod(option + 13, nullptr);
+
+		// A path with spaces is quoted.
+		filesystem::path eventLogPath;
+		if (const auto option = wcsstr(lpCmdLine, L"--event-log="); option != nullptr) {
+			const wstring_view value = option + 12;
+			eventLogPath = value.starts_with(L'"') ? value.substr(1, value.find(L'"', 1) - 1) : value.substr(0, value.find(L' '));
+		}
+
+		g_framePacer = make_unique<decltype(g_framePacer)::element_type>(frameRate > 0 ? 1 / frameRate : 0);
+
+		HandleT<HandleTraits::HANDLENullTraits> timer(CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS));
+		if (!timer.IsValid()) timer.Attach(CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS));
+
+		g_app = make_unique<decltype(g_app)::element_type>(g_windowModeHelper, seed, isSimulationThreaded, tickRate, eventLogPath);
 
 		ThrowIfFailed(g_windowModeHelper->Apply());
 
@@ -72,7 +119,12 @@ int WINAPI wWinMain(
 
 				if (g_exception) rethrow_exception(g_exception);
 			}
-			else g_app->Tick();
+			else if (g_framePacer->TryBeginFrame()) {
+				g_app->Tick();
+
+				g_framePacer->SetIdle(g_app->IsIdle() || IsIconic(window));
+			}
+			else WaitForFrameOrMessage(timer.Get(), g_framePacer->GetSecondsUntilNextFrame());
 		} while (msg.message != WM_QUIT);
 		ret = static_cast<decltype(ret)>(msg.wParam);
 	}
@@ -153,6 +205,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
 
 			case SIZE_RESTORED: g_app->OnResuming(); [[fallthrough]];
 			default: {
+				g_framePacer->Wake();
+
 				if (g_windowModeHelper->GetMode() != WindowMode::Fullscreen || g_windowModeHelper->IsFullscreenResolutionHandledByWindow()) {
 					g_windowModeHelper->SetResolution({ LOWORD(lParam), HIWORD(lParam) });
 				}
@@ -181,7 +235,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
 		} [[fallthrough]];
 		case WM_SYSKEYUP:
 		case WM_KEYDOWN:
-		case WM_KEYUP: g_app->ProcessKeyboardMessage(uMsg, wParam, lParam); break;
+		case WM_KEYUP: {
+			g_framePacer->Wake();
+
+			g_app->ProcessKeyboardMessage(uMsg, wParam, lParam);
+		} break;
 
 		case WM_LBUTTONDOWN:
 		case WM_RBUTTONDOWN:
@@ -189,6 +247,8 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
 		case WM_XBUTTONDOWN: {
 			SetCapture(hWnd);
 
+			g_framePacer->Wake();
+
 			g_app->ProcessMouseMessage(uMsg, wParam, lParam);
 		} break;
 
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A whole file mapped read-only, so that reading it costs page faults rather than copies. The mapping outlives the
+// file handle, which is closed as soon as the view exists.
+class MappedFile {
+public:
+	MappedFile() = default;
+
+	explicit MappedFile(const std::filesystem::path& path) {
+#ifdef _WIN32
+		const auto ThrowLastError = [] { throw std::system_error(static_cast<int>(GetLastError()), std::system_category()); };
+
+		const auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) ThrowLastError();
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size)) {
+			CloseHandle(file);
+			ThrowLastError();
+		}
+		m_size = static_cast<size_t>(size.QuadPart);
+
+		if (m_size) {
+			const auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr) {
+				m_data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+				CloseHandle(mapping);
+			}
+			if (m_data == nullptr) {
+				CloseHandle(file);
+				ThrowLastError();
+			}
+		}
+
+		CloseHandle(file);
+#else
+		const auto ThrowErrno = [] { throw std::system_error(errno, std::generic_category()); };
+
+		const auto file = open(path.c_str(), O_RDONLY);
+		if (file == -1) ThrowErrno();
+
+		struct stat status;
+		if (fstat(file, &status) == -1) {
+			close(file);
+			ThrowErrno();
+		}
+		m_size = static_cast<size_t>(status.st_size);
+
+		if (m_size) {
+			m_data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (m_data == MAP_FAILED) {
+				m_data = nullptr;
+				close(file);
+				ThrowErrno();
+			}
+		}
+
+		close(file);
+#endif
+	}
+
+	MappedFile(MappedFile&& other) noexcept : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+	MappedFile& operator=(MappedFile&& other) noexcept {
+		std::swap(m_data, other.m_data);
+		std::swap(m_size, other.m_size);
+		return *this;
+	}
+
+	~MappedFile() {
+		if (m_data == nullptr) return;
+
+#ifdef _WIN32
+		UnmapViewOfFile(m_data);
+#else
+		munmap(m_data, m_size);
+#endif
+	}
+
+	std::span<const std::byte> GetBytes() const noexcept { return { static_cast<const std::byte*>(m_data), m_size }; }
+
+private:
+	void* m_data{};
+	size_t m_size{};
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Random.h"
+
+#include <cstdint>
+
+// Policies for RolloutRunner: copyable callables that return whether to fly up before the next step.
+
+// Flies up whenever the pawn falls to the bottom of the next gap, which survives most courses for a long time.
+struct AutopilotPolicy {
+	template <typename TGame>
+	bool operator()(const TGame& game) const {
+		const auto& physics = game.GetPhysics();
+		const auto position = game.GetPawnPosition();
+		for (size_t i = 0; i < physics.GetBarrierCount(); i++) {
+			if (const auto barrier = physics.GetBarrier(i); barrier.PositionX + barrier.HalfWidth + TGame::PawnRadius > position.x) {
+				return position.y < barrier.GapBottom + TGame::PawnRadius + 0.06f && game.GetPawnLinearVelocity().y < 0;
+			}
+		}
+		return false;
+	}
+};
+
+// Flies up with a fixed probability per step. Each draw is keyed by the game's state hash, so a seeded episode plays
+// the same way on any worker.
+class RandomPolicy {
+public:
+	explicit RandomPolicy(float flyUpProbability, uint32_t seed = 0) noexcept : m_flyUpProbability(flyUpProbability), m_random(seed) {}
+
+	template <typename TGame>
+	bool operator()(const TGame& game) const { return m_random.FloatAt(game.GetStateHash()) < m_flyUpProbability; }
+
+private:
+	float m_flyUpProbability;
+
+	Random m_random;
+};
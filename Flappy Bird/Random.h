@@ -1,11 +1,47 @@
 #pragma once
 
+#include <cstdint>
 #include <random>
 
+// Counter-based generator: draw n after seeding is a SplitMix64 hash of the seed and n, so any draw can be computed
+// directly with FloatAt, out of order or from several threads, and the whole state is 16 bytes.
 struct Random {
-	float Float(float min = 0, float max = 1) { return min + (max - min) * m_distribution(m_generator); }
+	Random() : Random((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()()) {}
+
+	explicit Random(uint64_t seed) noexcept { Seed(seed); }
+
+	float Float(float min = 0, float max = 1) noexcept { return FloatAt(m_position++, min, max); }
+
+	float FloatAt(uint64_t index, float min = 0, float max = 1) const noexcept {
+		return min + (max - min) * (static_cast<float>(GetBitsAt(m_key, index)) / (1 << 24));
+	}
+
+	// The 24 bits FloatAt scales for draw index of the stream with key. With a Simd::UInt64 of keys, every lane draws
+	// from its own stream.
+	template <typename TUInt64>
+	static TUInt64 GetBitsAt(TUInt64 key, uint64_t index) noexcept { return Mix(key + (index + 1) * Increment) >> 40; }
+
+	// Number of draws since the last Seed; setting it skips ahead or rewinds the stream.
+	uint64_t GetPosition() const noexcept { return m_position; }
+	void SetPosition(uint64_t value) noexcept { m_position = value; }
+
+	// The mixed seed, which with the position is the whole state.
+	uint64_t GetKey() const noexcept { return m_key; }
+
+	void Seed(uint64_t value) noexcept {
+		m_key = Mix(value);
+		m_position = 0;
+	}
 
 private:
-	std::uniform_real_distribution<float> m_distribution = decltype(m_distribution)(0, 1);
-	std::mt19937 m_generator = decltype(m_generator)(std::random_device()());
+	static constexpr uint64_t Increment = 0x9e3779b97f4a7c15;
+
+	uint64_t m_key{}, m_position{};
+
+	template <typename TUInt64>
+	static constexpr TUInt64 Mix(TUInt64 value) noexcept {
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+		return value ^ (value >> 31);
+	}
 };
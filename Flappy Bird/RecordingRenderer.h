@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Renderer.h"
+
+// Counts what each frame asks a backend to draw instead of drawing it, so draw submission can be checked anywhere.
+class RecordingRenderer : public IRenderer {
+public:
+	struct Counts {
+		uint32_t DrawCalls, Sprites, Texts;
+	};
+
+	explicit RecordingRenderer(b2Vec2 size) noexcept : m_size(size) {}
+
+	// What the last frame submitted, or the current one until it ends.
+	const Counts& GetFrameCounts() const noexcept { return m_counts; }
+
+	uint64_t GetFrameCount() const noexcept { return m_frameCount; }
+
+	b2Vec2 GetSize() const override { return m_size; }
+
+	void BeginFrame() override { m_counts = {}; }
+
+	void EndFrame() override { m_frameCount++; }
+
+	void DrawBackground() override { m_counts.DrawCalls++; }
+
+	void FillRectangle(Brush, const Matrix3x2&) override { Record(1); }
+	void FillEllipse(Brush, const Matrix3x2&) override { Record(1); }
+
+	void FillRectangles(Brush, std::span<const Matrix3x2> transforms) override { Record(transforms.size()); }
+	void FillEllipses(Brush, std::span<const Matrix3x2> transforms) override { Record(transforms.size()); }
+
+	void RenderText(std::string_view, float, float, uint32_t) override {
+		m_counts.DrawCalls++;
+		m_counts.Texts++;
+	}
+
+private:
+	b2Vec2 m_size;
+
+	Counts m_counts{};
+
+	uint64_t m_frameCount{};
+
+	void Record(size_t spriteCount) noexcept {
+		m_counts.DrawCalls++;
+		m_counts.Sprites += static_cast<uint32_t>(spriteCount);
+	}
+};
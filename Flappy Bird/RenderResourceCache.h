@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Keeps the text formats, brushes and text layouts a renderer asks for, so a frame that draws the same strings as
+// the previous one creates nothing. Layouts not used during a frame are evicted when it ends, since every new score
+// makes one. Formats and brushes are few and stay until Invalidate, which renderers call when their target is
+// recreated.
+//
+// TBackend creates the resources:
+//   TextFormat CreateTextFormat(std::string_view fontFamily, float fontSize);
+//   SolidBrush CreateSolidBrush(uint32_t rgb);
+//   TextLayout CreateTextLayout(std::string_view text, const TextFormat& textFormat, float maxWidth, float maxHeight);
+template <typename TBackend>
+class RenderResourceCache {
+public:
+	using TextFormat = typename TBackend::TextFormat;
+	using SolidBrush = typename TBackend::SolidBrush;
+	using TextLayout = typename TBackend::TextLayout;
+
+	struct Statistics {
+		uint64_t Hits, Misses, Evictions;
+	};
+
+	RenderResourceCache() = default;
+
+	explicit RenderResourceCache(TBackend backend) : m_backend(std::move(backend)) {}
+
+	TBackend& GetBackend() noexcept { return m_backend; }
+
+	const Statistics& GetStatistics() const noexcept { return m_statistics; }
+
+	size_t GetSize() const noexcept { return m_textFormats.size() + m_solidBrushes.size() + m_textLayouts.size(); }
+
+	const TextFormat& GetTextFormat(std::string_view fontFamily, float fontSize) {
+		return Find(m_textFormats, MakeKey(fontFamily, fontSize, {}, {}), [&] { return m_backend.CreateTextFormat(fontFamily, fontSize); });
+	}
+
+	const SolidBrush& GetSolidBrush(uint32_t rgb) {
+		return Find(m_solidBrushes, rgb, [&] { return m_backend.CreateSolidBrush(rgb); });
+	}
+
+	const TextLayout& GetTextLayout(std::string_view text, std::string_view fontFamily, float fontSize, float maxWidth, float maxHeight) {
+		return Find(m_textLayouts, MakeKey(fontFamily, fontSize, maxWidth, text), [&] {
+			return m_backend.CreateTextLayout(text, GetTextFormat(fontFamily, fontSize), maxWidth, maxHeight);
+		});
+	}
+
+	void EndFrame() {
+		for (auto i = m_textLayouts.begin(); i != m_textLayouts.end();) {
+			if (i->second.LastFrame == m_frame) ++i;
+			else {
+				i = m_textLayouts.erase(i);
+				m_statistics.Evictions++;
+			}
+		}
+
+		m_frame++;
+	}
+
+	void Invalidate() {
+		m_statistics.Evictions += GetSize();
+
+		m_textFormats.clear();
+		m_solidBrushes.clear();
+		m_textLayouts.clear();
+	}
+
+private:
+	template <typename T>
+	struct Entry {
+		T Resource;
+		uint64_t LastFrame;
+	};
+
+	TBackend m_backend;
+
+	Statistics m_statistics{};
+
+	uint64_t m_frame{};
+
+	std::unordered_map<std::string, Entry<TextFormat>> m_textFormats;
+	std::unordered_map<uint32_t, Entry<SolidBrush>> m_solidBrushes;
+	std::unordered_map<std::string, Entry<TextLayout>> m_textLayouts;
+
+	// Reused so that lookups do not allocate once it has grown to the longest key.
+	std::string m_key;
+
+	const std::string& MakeKey(std::string_view fontFamily, float fontSize, float maxWidth, std::string_view text) {
+		m_key.assign(fontFamily);
+		m_key.push_back('\0');
+		m_key.append(reinterpret_cast<const char*>(&fontSize), sizeof(fontSize));
+		m_key.append(reinterpret_cast<const char*>(&maxWidth), sizeof(maxWidth));
+		m_key.append(text);
+		return m_key;
+	}
+
+	template <typename TMap, typename TKey, typename TCreate>
+	const auto& Find(TMap& map, const TKey& key, TCreate&& create) {
+		if (const auto i = map.find(key); i != map.end()) {
+			m_statistics.Hits++;
+			i->second.LastFrame = m_frame;
+			return i->second.Resource;
+		}
+
+		m_statistics.Misses++;
+
+		// Creating a layout looks up its text format, which reuses m_key.
+		TKey ownedKey(key);
+		auto resource = create();
+		return map.insert_or_assign(std::move(ownedKey), Entry<decltype(resource)>{ std::move(resource), m_frame }).first->second.Resource;
+	}
+};
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "Box2DPhysics.h"
+
+#include "Trace.h"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Affine transform with the same layout and row-vector convention as D2D1_MATRIX_3X2_F: a * b applies a first.
+struct Matrix3x2 {
+	float M11 = 1, M12 = 0, M21 = 0, M22 = 1, Dx = 0, Dy = 0;
+
+	static Matrix3x2 Scale(float x, float y) noexcept { return { x, 0, 0, y, 0, 0 }; }
+
+	static Matrix3x2 Translation(float x, float y) noexcept { return { 1, 0, 0, 1, x, y }; }
+
+	// Same direction as D2D1::Matrix3x2F::Rotation: clockwise on a y-down target for positive angles.
+	static Matrix3x2 Rotation(float radians, b2Vec2 center) noexcept {
+		const auto cos = std::cos(radians), sin = std::sin(radians);
+		return Translation(-center.x, -center.y) * Matrix3x2{ cos, sin, -sin, cos, 0, 0 } * Translation(center.x, center.y);
+	}
+
+	friend Matrix3x2 operator*(const Matrix3x2& a, const Matrix3x2& b) noexcept {
+		return {
+			a.M11 * b.M11 + a.M12 * b.M21, a.M11 * b.M12 + a.M12 * b.M22,
+			a.M21 * b.M11 + a.M22 * b.M21, a.M21 * b.M12 + a.M22 * b.M22,
+			a.Dx * b.M11 + a.Dy * b.M21 + b.Dx, a.Dx * b.M12 + a.Dy * b.M22 + b.Dy
+		};
+	}
+
+	b2Vec2 TransformPoint(b2Vec2 point) const noexcept { return { point.x * M11 + point.y * M21 + Dx, point.x * M12 + point.y * M22 + Dy }; }
+
+	Matrix3x2 Inverse() const noexcept {
+		const auto inverseDeterminant = 1 / (M11 * M22 - M12 * M21);
+		return {
+			M22 * inverseDeterminant, -M12 * inverseDeterminant,
+			-M21 * inverseDeterminant, M11 * inverseDeterminant,
+			(M21 * Dy - M22 * Dx) * inverseDeterminant, (M12 * Dx - M11 * Dy) * inverseDeterminant
+		};
+	}
+};
+
+enum class Brush { Background, Pawn, Barrier };
+
+// A two-stop gradient from (0, 0) to End, interpolated in sRGB as Direct2D does by default. Sprite brushes span the
+// unit square being filled; the background spans the whole output.
+struct LinearGradient {
+	uint32_t StartRgb, EndRgb;
+	b2Vec2 End;
+};
+
+inline constexpr LinearGradient GetGradient(Brush brush) noexcept {
+	constexpr uint32_t WhiteSmoke = 0xf5f5f5, LightSkyBlue = 0x87cefa, DarkCyan = 0x008b8b;
+
+	switch (brush) {
+	case Brush::Pawn: return { WhiteSmoke, DarkCyan, { 1, 0 } };
+	default: return { WhiteSmoke, LightSkyBlue, { 0, 1 } };
+	}
+}
+
+// Everything the game draws, in output pixels with y down.
+struct IRenderer {
+	virtual ~IRenderer() = default;
+
+	virtual b2Vec2 GetSize() const = 0;
+
+	virtual void BeginFrame() = 0;
+	virtual void EndFrame() = 0;
+
+	virtual void DrawBackground() = 0;
+
+	// Fill the unit square, or the ellipse inscribed in it, mapped through transform.
+	virtual void FillRectangle(Brush brush, const Matrix3x2& transform) = 0;
+	virtual void FillEllipse(Brush brush, const Matrix3x2& transform) = 0;
+
+	// The same for many transforms, which backends that can draw them together override with a single draw.
+	virtual void FillRectangles(Brush brush, std::span<const Matrix3x2> transforms) {
+		for (const auto& transform : transforms) FillRectangle(brush, transform);
+	}
+	virtual void FillEllipses(Brush brush, std::span<const Matrix3x2> transforms) {
+		for (const auto& transform : transforms) FillEllipse(brush, transform);
+	}
+
+	// Draws one line of ASCII text centered in the full-width box [top, top + fontSize].
+	virtual void RenderText(std::string_view text, float fontSize, float top, uint32_t rgb) = 0;
+};
+
+// Maps world units, y up, to output pixels: the world height fills the output and the world is centered horizontally.
+inline Matrix3x2 GetWorldTransform(b2Vec2 outputSize, b2Vec2 worldSize) noexcept {
+	const auto scale = outputSize.y / worldSize.y;
+	return Matrix3x2::Scale(scale, -scale) * Matrix3x2::Translation((outputSize.x - worldSize.x * scale) / 2, outputSize.y);
+}
+
+// Everything RenderGame reads, copied out of a game so that it can be drawn while the game keeps running. Only
+// sprites that overlap the world's width are captured.
+struct RenderSnapshot {
+	static constexpr size_t MaxSpriteCount = 1 + 2 * 32;
+
+	b2Vec2 WorldSize;
+	uint32_t Score, TickCount;
+	float TickScrollX;
+	bool IsRunning, IsOver;
+
+	uint32_t SpriteCount;
+	std::array<Sprite, MaxSpriteCount> Sprites;
+
+	// Sprites beyond MaxSpriteCount are dropped.
+	template <typename TGame>
+	void Capture(const TGame& game) noexcept {
+		WorldSize = game.GetWorldSize();
+		Score = game.GetScore();
+		TickCount = game.GetTickCount();
+		TickScrollX = game.GetTickScrollX();
+		IsRunning = game.GetState() == TGame::State::Running;
+		IsOver = game.GetState() == TGame::State::Over;
+
+		const auto& physics = game.GetPhysics();
+
+		const auto position = physics.GetPawnPosition();
+		constexpr auto Radius = TGame::PawnRadius;
+		Sprites[0] = { ObjectType::Pawn, true, position.x - Radius, position.y + Radius, position.x + Radius, position.y - Radius, physics.GetPawnAngle() };
+		SpriteCount = 1;
+
+		// Barriers are ordered by x, so the visible ones are a run that ends at the first one past the right edge.
+		for (size_t i = 0; i < physics.GetBarrierCount() && SpriteCount + 2 <= MaxSpriteCount; i++) {
+			const auto barrier = physics.GetBarrier(i);
+			const auto left = barrier.PositionX - barrier.HalfWidth, right = barrier.PositionX + barrier.HalfWidth;
+			if (right + TickScrollX < 0) continue;
+			if (left > WorldSize.x) break;
+
+			Sprites[SpriteCount++] = { ObjectType::BarrierBottom, false, left, barrier.GapBottom, right, 0, 0 };
+			Sprites[SpriteCount++] = { ObjectType::BarrierTop, false, left, barrier.Top, right, barrier.GapTop, 0 };
+		}
+	}
+
+	// The frame alpha of the way from previous to current, the tick after it: the pawn is blended between the two and
+	// barriers are moved back by the rest of current's scroll, so they need not be matched up. Anything but two
+	// consecutive ticks of one game, or a blend of 1 or more, is current as is.
+	void Interpolate(const RenderSnapshot& previous, const RenderSnapshot& current, float alpha) noexcept {
+		*this = current;
+
+		if (alpha >= 1 || current.TickCount != previous.TickCount + 1 || current.WorldSize.x != previous.WorldSize.x) return;
+
+		const auto Blend = [&](float from, float to) { return from + (to - from) * alpha; };
+
+		auto& pawn = Sprites[0];
+		const auto& previousPawn = previous.Sprites[0];
+		pawn = { pawn.ObjectType, pawn.IsEllipse, Blend(previousPawn.Left, pawn.Left), Blend(previousPawn.Top, pawn.Top), Blend(previousPawn.Right, pawn.Right), Blend(previousPawn.Bottom, pawn.Bottom), Blend(previousPawn.Angle, pawn.Angle) };
+
+		const auto offsetX = (1 - alpha) * current.TickScrollX;
+		for (uint32_t i = 1; i < SpriteCount; i++) {
+			Sprites[i].Left += offsetX;
+			Sprites[i].Right += offsetX;
+		}
+	}
+};
+
+// Computes every sprite's output transform in one pass and groups them by brush and shape, so that a frame issues
+// one fill per group however many sprites there are. Cleared rather than reallocated between frames.
+class SpriteBatch {
+public:
+	void Clear() noexcept {
+		for (auto& transforms : m_transforms) transforms.clear();
+	}
+
+	void Add(std::span<const Sprite> sprites, const Matrix3x2& worldTransform) {
+		for (const auto& sprite : sprites) {
+			Brush brush;
+			auto angleDelta = 0.0f;
+			switch (sprite.ObjectType) {
+			case ObjectType::Pawn: brush = Brush::Pawn; break;
+
+			case ObjectType::BarrierTop: angleDelta = b2_pi; [[fallthrough]];
+			case ObjectType::BarrierBottom: brush = Brush::Barrier; break;
+
+			default: continue;
+			}
+
+			const b2Vec2 scale{ sprite.Right - sprite.Left, sprite.Bottom - sprite.Top };
+			m_transforms[GetGroup(brush, sprite.IsEllipse)].emplace_back(Matrix3x2::Scale(scale.x, scale.y) * Matrix3x2::Rotation(sprite.Angle + angleDelta, { scale.x / 2, scale.y / 2 }) * Matrix3x2::Translation(sprite.Left, sprite.Top) * worldTransform);
+		}
+	}
+
+	void Submit(IRenderer& renderer) const {
+		for (const auto brush : { Brush::Background, Brush::Pawn, Brush::Barrier }) {
+			if (const auto& transforms = m_transforms[GetGroup(brush, false)]; !transforms.empty()) renderer.FillRectangles(brush, transforms);
+			if (const auto& transforms = m_transforms[GetGroup(brush, true)]; !transforms.empty()) renderer.FillEllipses(brush, transforms);
+		}
+	}
+
+private:
+	std::array<std::vector<Matrix3x2>, 3 * 2> m_transforms;
+
+	static size_t GetGroup(Brush brush, bool isEllipse) noexcept { return static_cast<size_t>(brush) * 2 + isEllipse; }
+};
+
+inline void RenderGame(IRenderer& renderer, const RenderSnapshot& snapshot, const Matrix3x2& worldTransform, SpriteBatch& spriteBatch) {
+	{
+		TRACE_ZONE("RenderBackground");
+
+		renderer.DrawBackground();
+	}
+
+	{
+		TRACE_ZONE("RenderWorld");
+
+		spriteBatch.Clear();
+		spriteBatch.Add(std::span(snapshot.Sprites.data(), snapshot.SpriteCount), worldTransform);
+		spriteBatch.Submit(renderer);
+	}
+
+	TRACE_ZONE("RenderUI");
+
+	const auto height = renderer.GetSize().y;
+
+	renderer.RenderText(std::to_string(snapshot.Score), 0.08f * height, 0.1f * height, 0x0063b1);
+
+	if (snapshot.IsOver) {
+		renderer.RenderText("Game Over", 0.1f * height, 0.4f * height, 0xea005e);
+
+		renderer.RenderText("Press any key to restart.", 0.04f * height, 0.6f * height, 0x008080);
+	}
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include "Determinism.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+// A recorded run: the header, one input bit per tick, full game states every KeyframeInterval ticks and an index of
+// them at the end. Every section sits at an offset the header gives, aligned to 8 bytes, so a reader maps the file
+// and reads fields in place; scanning many replays only touches their headers. Integers are little-endian.
+//
+// Keyframe k is the state after its tick count of ticks, before that tick's press. Seeking restores the last keyframe
+// at or before the tick and replays at most KeyframeInterval - 1 ticks through Update.
+struct ReplayHeader {
+	static constexpr char FileMagic[4]{ 'F', 'B', 'R', 'P' };
+
+	static constexpr uint32_t CurrentVersion = 1;
+
+	enum class PhysicsType : uint32_t { Box2D, Analytic };
+
+	char Magic[4];
+	uint32_t Version;
+	PhysicsType Physics;
+	uint32_t KeyframeSize;
+
+	uint32_t Seed;
+	float WorldWidth, StepSeconds;
+	uint32_t TickCount, KeyframeInterval, KeyframeCount;
+
+	// Resets during the run plus one, and the score when it ended.
+	uint32_t EpisodeCount, FinalScore;
+
+	uint64_t InputsOffset, KeyframesOffset, IndexOffset;
+};
+
+static_assert(sizeof(ReplayHeader) == 72 && std::is_trivially_copyable_v<ReplayHeader>);
+
+struct ReplayIndexEntry {
+	uint32_t Tick, Reserved;
+	uint64_t Offset;
+};
+
+template <typename TGame>
+constexpr ReplayHeader::PhysicsType GetReplayPhysicsType() noexcept {
+	return std::is_same_v<typename TGame::Physics, AnalyticPhysics> ? ReplayHeader::PhysicsType::Analytic : ReplayHeader::PhysicsType::Box2D;
+}
+
+// Plays trace and writes it as a replay with a keyframe every keyframeInterval ticks, including one at the start.
+template <typename TGame = Game>
+void WriteReplay(std::ostream& stream, const InputTrace& trace, uint32_t keyframeInterval = 60) {
+	using SavedState = typename TGame::SavedState;
+
+	if (!keyframeInterval) throw std::invalid_argument("Keyframe interval must be positive");
+
+	constexpr auto Align = [](uint64_t value) { return (value + 7) / 8 * 8; };
+	constexpr auto KeyframeStride = Align(sizeof(SavedState));
+
+	const auto tickCount = static_cast<uint32_t>(trace.Presses.size());
+	const auto keyframeCount = tickCount / keyframeInterval + 1;
+
+	ReplayHeader header{};
+	std::copy_n(ReplayHeader::FileMagic, sizeof(header.Magic), header.Magic);
+	header.Version = ReplayHeader::CurrentVersion;
+	header.Physics = GetReplayPhysicsType<TGame>();
+	header.KeyframeSize = sizeof(SavedState);
+	header.Seed = trace.Seed;
+	header.WorldWidth = trace.WorldWidth;
+	header.StepSeconds = trace.StepSeconds;
+	header.TickCount = tickCount;
+	header.KeyframeInterval = keyframeInterval;
+	header.KeyframeCount = keyframeCount;
+	header.EpisodeCount = 1;
+	header.InputsOffset = sizeof(ReplayHeader);
+	header.KeyframesOffset = Align(header.InputsOffset + (tickCount + 7) / 8);
+	header.IndexOffset = header.KeyframesOffset + keyframeCount * KeyframeStride;
+
+	std::vector<std::byte> inputs(header.KeyframesOffset - header.InputsOffset), keyframes(header.IndexOffset - header.KeyframesOffset);
+	std::vector<ReplayIndexEntry> index(keyframeCount);
+
+	TGame game(trace.WorldWidth, trace.Seed);
+	SavedState state;
+	for (uint32_t tick = 0;; tick++) {
+		if (tick % keyframeInterval == 0) {
+			const auto keyframe = tick / keyframeInterval;
+			game.Snapshot(state);
+			std::memcpy(keyframes.data() + keyframe * KeyframeStride, &state, sizeof(state));
+			index[keyframe] = { tick, 0, header.KeyframesOffset + keyframe * KeyframeStride };
+		}
+
+		if (tick == tickCount) break;
+
+		if (trace.Presses[tick]) {
+			inputs[tick / 8] |= std::byte(1 << tick % 8);
+
+			if (game.GetState() == TGame::State::Over) {
+				game.Reset();
+				header.EpisodeCount++;
+			}
+			else game.FlyUp();
+		}
+
+		game.Update(trace.StepSeconds);
+	}
+	header.FinalScore = game.GetScore();
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(inputs.data()), static_cast<std::streamsize>(inputs.size()));
+	stream.write(reinterpret_cast<const char*>(keyframes.data()), static_cast<std::streamsize>(keyframes.size()));
+	stream.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size() * sizeof(ReplayIndexEntry)));
+}
+
+// Reads a replay in place, typically from a MappedFile. Construction checks the header and that every section lies
+// within bytes; nothing else is parsed up front.
+class ReplayReader {
+public:
+	explicit ReplayReader(std::span<const std::byte> bytes) : m_bytes(bytes) {
+		if (bytes.size() < sizeof(ReplayHeader)) throw std::runtime_error("Not a replay");
+
+		std::memcpy(&m_header, bytes.data(), sizeof(m_header));
+		if (!std::equal(m_header.Magic, m_header.Magic + sizeof(m_header.Magic), ReplayHeader::FileMagic) || m_header.Version != ReplayHeader::CurrentVersion) {
+			throw std::runtime_error("Not a replay");
+		}
+
+		if (!m_header.KeyframeCount
+			|| m_header.InputsOffset + (m_header.TickCount + 7ull) / 8 > m_header.KeyframesOffset
+			|| m_header.KeyframesOffset + static_cast<uint64_t>(m_header.KeyframeCount) * m_header.KeyframeSize > m_header.IndexOffset
+			|| m_header.IndexOffset + static_cast<uint64_t>(m_header.KeyframeCount) * sizeof(ReplayIndexEntry) > bytes.size()) {
+			throw std::runtime_error("Truncated replay");
+		}
+	}
+
+	const ReplayHeader& GetHeader() const noexcept { return m_header; }
+
+	// Whether the player pressed before tick.
+	bool IsPressed(uint32_t tick) const noexcept {
+		return (std::to_integer<uint32_t>(m_bytes[m_header.InputsOffset + tick / 8]) >> tick % 8) & 1;
+	}
+
+	InputTrace GetInputTrace() const {
+		InputTrace trace;
+		trace.Seed = m_header.Seed;
+		trace.WorldWidth = m_header.WorldWidth;
+		trace.StepSeconds = m_header.StepSeconds;
+		trace.Presses.resize(m_header.TickCount);
+		for (uint32_t tick = 0; tick < m_header.TickCount; tick++) trace.Presses[tick] = IsPressed(tick);
+		return trace;
+	}
+
+	ReplayIndexEntry GetKeyframe(uint32_t index) const {
+		ReplayIndexEntry entry;
+		std::memcpy(&entry, m_bytes.data() + m_header.IndexOffset + index * sizeof(ReplayIndexEntry), sizeof(entry));
+		if (entry.Offset + m_header.KeyframeSize > m_header.IndexOffset) throw std::runtime_error("Corrupt replay index");
+		return entry;
+	}
+
+	// Puts game at the start of tick, whatever state it was in.
+	template <typename TGame = Game>
+	void Seek(TGame& game, uint32_t tick) const {
+		using SavedState = typename TGame::SavedState;
+
+		if (m_header.Physics != GetReplayPhysicsType<TGame>() || m_header.KeyframeSize != sizeof(SavedState)) throw std::invalid_argument("Replay recorded with a different game");
+		if (tick > m_header.TickCount) throw std::out_of_range("Tick past the end of the replay");
+
+		// The last keyframe at or before tick.
+		uint32_t first = 0, count = m_header.KeyframeCount;
+		while (count > 1) {
+			const auto half = count / 2;
+			if (GetKeyframe(first + half).Tick <= tick) first += half;
+			count -= half;
+		}
+		const auto keyframe = GetKeyframe(first);
+
+		SavedState state;
+		std::memcpy(&state, m_bytes.data() + keyframe.Offset, sizeof(state));
+		if (!TGame::CanRestore(state)) throw std::runtime_error("Corrupt replay");
+		game.Restore(state);
+
+		for (auto i = keyframe.Tick; i < tick; i++) {
+			if (IsPressed(i)) {
+				if (game.GetState() == TGame::State::Over) game.Reset();
+				else game.FlyUp();
+			}
+
+			game.Update(m_header.StepSeconds);
+		}
+	}
+
+private:
+	std::span<const std::byte> m_bytes;
+
+	ReplayHeader m_header;
+};
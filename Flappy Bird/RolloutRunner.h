@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Game.h"
+
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <vector>
+
+struct RolloutResult {
+	uint32_t Score;
+	uint32_t Steps;
+	bool IsOver;
+};
+
+struct RolloutStats {
+	uint32_t ThreadCount{};
+	uint64_t Episodes{}, Steps{};
+	double Seconds{};
+
+	double GetEpisodesPerSecond() const noexcept { return Seconds > 0 ? Episodes / Seconds : 0; }
+	double GetStepsPerSecond() const noexcept { return Seconds > 0 ? Steps / Seconds : 0; }
+};
+
+// Plays many independent headless games on a ThreadPool.
+// A policy is any copyable callable bool(const TGame&) that returns whether to fly up before the next step.
+// Every worker plays on its own copy of the policy and its own Game, which is Reset() between episodes.
+class RolloutRunner {
+public:
+	struct Options {
+		float WorldWidth = 12 * 16 / 9.0f;
+		float StepSeconds = 1 / 60.0f;
+		uint32_t MaxSteps = 60 * 60 * 5;
+
+		// Episode i plays the course seeded FirstSeed + i, so that results do not depend on which worker played it.
+		// Without it every game draws its own random courses.
+		std::optional<uint32_t> FirstSeed;
+	};
+
+	explicit RolloutRunner(uint32_t threadCount = std::thread::hardware_concurrency()) : m_threadPool(threadCount) {}
+
+	uint32_t GetThreadCount() const noexcept { return m_threadPool.GetThreadCount(); }
+
+	template <typename TGame = Game, typename TPolicy>
+	RolloutStats Run(uint64_t episodeCount, const TPolicy& policy, const Options& options, std::vector<RolloutResult>* pResults = nullptr) {
+		if (pResults != nullptr) pResults->resize(episodeCount);
+
+		struct alignas(64) Worker {
+			std::unique_ptr<TGame> Instance;
+			std::optional<TPolicy> Policy;
+			uint64_t Steps{};
+		};
+		std::vector<Worker> workers(m_threadPool.GetThreadCount());
+
+		const auto start = std::chrono::steady_clock::now();
+
+		m_threadPool.Run(episodeCount, [&](uint64_t index, uint32_t workerIndex) {
+			auto& worker = workers[workerIndex];
+			if (!worker.Instance) {
+				worker.Instance = std::make_unique<TGame>(options.WorldWidth);
+				worker.Policy.emplace(policy);
+			}
+			else if (!options.FirstSeed) worker.Instance->Reset();
+
+			if (options.FirstSeed) worker.Instance->Reset(static_cast<uint32_t>(*options.FirstSeed + index));
+
+			const auto result = Play(*worker.Instance, *worker.Policy, options);
+			worker.Steps += result.Steps;
+			if (pResults != nullptr) (*pResults)[index] = result;
+		});
+
+		RolloutStats stats{ .ThreadCount = m_threadPool.GetThreadCount(), .Episodes = episodeCount };
+		stats.Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		for (const auto& worker : workers) stats.Steps += worker.Steps;
+		return stats;
+	}
+
+	template <typename TGame, typename TPolicy>
+	static RolloutResult Play(TGame& game, TPolicy& policy, const Options& options) {
+		uint32_t steps = 0;
+		while (game.GetState() != TGame::State::Over && steps < options.MaxSteps) {
+			if (policy(static_cast<const TGame&>(game))) game.FlyUp();
+
+			game.Update(options.StepSeconds);
+
+			steps++;
+		}
+		return { game.GetScore(), steps, game.GetState() == TGame::State::Over };
+	}
+
+private:
+	ThreadPool m_threadPool;
+};
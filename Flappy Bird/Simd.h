@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// Thin wrappers over the widest float/int32 vectors the target was compiled for: AVX2, SSE2 or plain scalars. UInt64
+// holds Width 64-bit lanes and only has the operations integer hashing needs.
+// Kernels written against them process Simd::Width lanes at a time and compile unchanged for every target.
+namespace Simd {
+#if SIMD_AVX2
+	constexpr size_t Width = 8;
+
+	struct Mask { __m256 Value; };
+
+	struct Int { __m256i Value; };
+
+	struct Float { __m256 Value; };
+
+	inline Float Broadcast(float value) noexcept { return { _mm256_set1_ps(value) }; }
+	inline Float Load(const float* p) noexcept { return { _mm256_loadu_ps(p) }; }
+	inline void Store(float* p, Float value) noexcept { _mm256_storeu_ps(p, value.Value); }
+
+	inline Int BroadcastInt(int32_t value) noexcept { return { _mm256_set1_epi32(value) }; }
+	inline Int Load(const int32_t* p) noexcept { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+	inline void Store(int32_t* p, Int value) noexcept { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), value.Value); }
+
+	inline Int Iota() noexcept { return { _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7) }; }
+
+	// Lanes are set where the byte is non-zero.
+	inline Mask LoadMask(const uint8_t* p) noexcept {
+		const auto bytes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+		return { _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(bytes, _mm256_setzero_si256()), _mm256_set1_epi32(-1))) };
+	}
+
+	inline Float operator+(Float a, Float b) noexcept { return { _mm256_add_ps(a.Value, b.Value) }; }
+	inline Float operator-(Float a, Float b) noexcept { return { _mm256_sub_ps(a.Value, b.Value) }; }
+	inline Float operator*(Float a, Float b) noexcept { return { _mm256_mul_ps(a.Value, b.Value) }; }
+	inline Float operator/(Float a, Float b) noexcept { return { _mm256_div_ps(a.Value, b.Value) }; }
+	inline Float Min(Float a, Float b) noexcept { return { _mm256_min_ps(a.Value, b.Value) }; }
+	inline Float Max(Float a, Float b) noexcept { return { _mm256_max_ps(a.Value, b.Value) }; }
+	inline Float Sqrt(Float a) noexcept { return { _mm256_sqrt_ps(a.Value) }; }
+	inline Float Floor(Float a) noexcept { return { _mm256_floor_ps(a.Value) }; }
+
+	inline Mask operator<(Float a, Float b) noexcept { return { _mm256_cmp_ps(a.Value, b.Value, _CMP_LT_OQ) }; }
+	inline Mask operator<=(Float a, Float b) noexcept { return { _mm256_cmp_ps(a.Value, b.Value, _CMP_LE_OQ) }; }
+	inline Mask operator>(Float a, Float b) noexcept { return { _mm256_cmp_ps(a.Value, b.Value, _CMP_GT_OQ) }; }
+	inline Mask operator>=(Float a, Float b) noexcept { return { _mm256_cmp_ps(a.Value, b.Value, _CMP_GE_OQ) }; }
+
+	inline Mask operator&(Mask a, Mask b) noexcept { return { _mm256_and_ps(a.Value, b.Value) }; }
+	inline Mask operator|(Mask a, Mask b) noexcept { return { _mm256_or_ps(a.Value, b.Value) }; }
+	inline Mask AndNot(Mask a, Mask b) noexcept { return { _mm256_andnot_ps(b.Value, a.Value) }; }
+	inline uint32_t ToBits(Mask a) noexcept { return static_cast<uint32_t>(_mm256_movemask_ps(a.Value)); }
+
+	inline Float Select(Mask mask, Float a, Float b) noexcept { return { _mm256_blendv_ps(b.Value, a.Value, mask.Value) }; }
+	inline Int Select(Mask mask, Int a, Int b) noexcept {
+		return { _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b.Value), _mm256_castsi256_ps(a.Value), mask.Value)) };
+	}
+
+	inline Int operator+(Int a, Int b) noexcept { return { _mm256_add_epi32(a.Value, b.Value) }; }
+	inline Int operator*(Int a, Int b) noexcept { return { _mm256_mullo_epi32(a.Value, b.Value) }; }
+	inline Int operator&(Int a, Int b) noexcept { return { _mm256_and_si256(a.Value, b.Value) }; }
+	inline Mask operator==(Int a, Int b) noexcept { return { _mm256_castsi256_ps(_mm256_cmpeq_epi32(a.Value, b.Value)) }; }
+
+	// Truncates toward zero.
+	inline Int ToInt(Float a) noexcept { return { _mm256_cvttps_epi32(a.Value) }; }
+	inline Float ToFloat(Int a) noexcept { return { _mm256_cvtepi32_ps(a.Value) }; }
+
+	inline Float Gather(const float* base, Int indices) noexcept { return { _mm256_i32gather_ps(base, indices.Value, 4) }; }
+
+	// Lanes 0-3 and 4-7.
+	struct UInt64 { __m256i Low, High; };
+
+	inline UInt64 Load(const uint64_t* p) noexcept {
+		return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 4)) };
+	}
+
+	inline UInt64 operator+(UInt64 a, uint64_t b) noexcept {
+		const auto value = _mm256_set1_epi64x(static_cast<int64_t>(b));
+		return { _mm256_add_epi64(a.Low, value), _mm256_add_epi64(a.High, value) };
+	}
+
+	// AVX2 only multiplies 32-bit halves: the high half of the product is the sum of the two cross products.
+	inline UInt64 operator*(UInt64 a, uint64_t b) noexcept {
+		const auto low = _mm256_set1_epi64x(static_cast<int64_t>(b & 0xffffffff)), high = _mm256_set1_epi64x(static_cast<int64_t>(b >> 32));
+		const auto Multiply = [&](__m256i x) {
+			const auto cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(x, 32), low), _mm256_mul_epu32(x, high));
+			return _mm256_add_epi64(_mm256_mul_epu32(x, low), _mm256_slli_epi64(cross, 32));
+		};
+		return { Multiply(a.Low), Multiply(a.High) };
+	}
+
+	inline UInt64 operator^(UInt64 a, UInt64 b) noexcept { return { _mm256_xor_si256(a.Low, b.Low), _mm256_xor_si256(a.High, b.High) }; }
+
+	inline UInt64 operator>>(UInt64 a, int count) noexcept {
+		const auto shift = _mm_cvtsi32_si128(count);
+		return { _mm256_srl_epi64(a.Low, shift), _mm256_srl_epi64(a.High, shift) };
+	}
+
+	// Keeps the low 32 bits of every lane.
+	inline Int ToInt(UInt64 a) noexcept {
+		const auto even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+		return { _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(a.Low, even), _mm256_permutevar8x32_epi32(a.High, even), 0x20) };
+	}
+#elif SIMD_SSE2
+	constexpr size_t Width = 4;
+
+	struct Mask { __m128 Value; };
+
+	struct Int { __m128i Value; };
+
+	struct Float { __m128 Value; };
+
+	inline Float Broadcast(float value) noexcept { return { _mm_set1_ps(value) }; }
+	inline Float Load(const float* p) noexcept { return { _mm_loadu_ps(p) }; }
+	inline void Store(float* p, Float value) noexcept { _mm_storeu_ps(p, value.Value); }
+
+	inline Int BroadcastInt(int32_t value) noexcept { return { _mm_set1_epi32(value) }; }
+	inline Int Load(const int32_t* p) noexcept { return { _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) }; }
+	inline void Store(int32_t* p, Int value) noexcept { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), value.Value); }
+
+	inline Int Iota() noexcept { return { _mm_setr_epi32(0, 1, 2, 3) }; }
+
+	inline Mask LoadMask(const uint8_t* p) noexcept {
+		int32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		const auto zero = _mm_setzero_si128();
+		const auto bytes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(value), zero), zero);
+		return { _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(bytes, zero), _mm_set1_epi32(-1))) };
+	}
+
+	inline Float operator+(Float a, Float b) noexcept { return { _mm_add_ps(a.Value, b.Value) }; }
+	inline Float operator-(Float a, Float b) noexcept { return { _mm_sub_ps(a.Value, b.Value) }; }
+	inline Float operator*(Float a, Float b) noexcept { return { _mm_mul_ps(a.Value, b.Value) }; }
+	inline Float operator/(Float a, Float b) noexcept { return { _mm_div_ps(a.Value, b.Value) }; }
+	inline Float Min(Float a, Float b) noexcept { return { _mm_min_ps(a.Value, b.Value) }; }
+	inline Float Max(Float a, Float b) noexcept { return { _mm_max_ps(a.Value, b.Value) }; }
+	inline Float Sqrt(Float a) noexcept { return { _mm_sqrt_ps(a.Value) }; }
+
+	inline Mask operator<(Float a, Float b) noexcept { return { _mm_cmplt_ps(a.Value, b.Value) }; }
+	inline Mask operator<=(Float a, Float b) noexcept { return { _mm_cmple_ps(a.Value, b.Value) }; }
+	inline Mask operator>(Float a, Float b) noexcept { return { _mm_cmpgt_ps(a.Value, b.Value) }; }
+	inline Mask operator>=(Float a, Float b) noexcept { return { _mm_cmpge_ps(a.Value, b.Value) }; }
+
+	inline Mask operator&(Mask a, Mask b) noexcept { return { _mm_and_ps(a.Value, b.Value) }; }
+	inline Mask operator|(Mask a, Mask b) noexcept { return { _mm_or_ps(a.Value, b.Value) }; }
+	inline Mask AndNot(Mask a, Mask b) noexcept { return { _mm_andnot_ps(b.Value, a.Value) }; }
+	inline uint32_t ToBits(Mask a) noexcept { return static_cast<uint32_t>(_mm_movemask_ps(a.Value)); }
+
+	inline Float Select(Mask mask, Float a, Float b) noexcept { return { _mm_or_ps(_mm_and_ps(mask.Value, a.Value), _mm_andnot_ps(mask.Value, b.Value)) }; }
+	inline Int Select(Mask mask, Int a, Int b) noexcept {
+		const auto m = _mm_castps_si128(mask.Value);
+		return { _mm_or_si128(_mm_and_si128(m, a.Value), _mm_andnot_si128(m, b.Value)) };
+	}
+
+	inline Int operator+(Int a, Int b) noexcept { return { _mm_add_epi32(a.Value, b.Value) }; }
+	inline Int operator*(Int a, Int b) noexcept {
+		const auto even = _mm_mul_epu32(a.Value, b.Value), odd = _mm_mul_epu32(_mm_srli_epi64(a.Value, 32), _mm_srli_epi64(b.Value, 32));
+		return { _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0))) };
+	}
+	inline Int operator&(Int a, Int b) noexcept { return { _mm_and_si128(a.Value, b.Value) }; }
+	inline Mask operator==(Int a, Int b) noexcept { return { _mm_castsi128_ps(_mm_cmpeq_epi32(a.Value, b.Value)) }; }
+
+	inline Int ToInt(Float a) noexcept { return { _mm_cvttps_epi32(a.Value) }; }
+	inline Float ToFloat(Int a) noexcept { return { _mm_cvtepi32_ps(a.Value) }; }
+
+	// SSE2 has no rounding instruction: truncate, then step down where truncation rounded a negative value up.
+	inline Float Floor(Float a) noexcept {
+		const auto truncated = ToFloat(ToInt(a));
+		return { _mm_sub_ps(truncated.Value, _mm_and_ps(_mm_cmpgt_ps(truncated.Value, a.Value), _mm_set1_ps(1))) };
+	}
+
+	inline Float Gather(const float* base, Int indices) noexcept {
+		alignas(16) int32_t i[4];
+		_mm_store_si128(reinterpret_cast<__m128i*>(i), indices.Value);
+		return { _mm_setr_ps(base[i[0]], base[i[1]], base[i[2]], base[i[3]]) };
+	}
+
+	// SSE2 multiplies two 64-bit lanes at a time and only from their 32-bit halves, so scalars are faster.
+	struct UInt64 { uint64_t Value[4]; };
+
+	inline UInt64 Load(const uint64_t* p) noexcept { return { { p[0], p[1], p[2], p[3] } }; }
+
+	inline UInt64 operator+(UInt64 a, uint64_t b) noexcept { return { { a.Value[0] + b, a.Value[1] + b, a.Value[2] + b, a.Value[3] + b } }; }
+	inline UInt64 operator*(UInt64 a, uint64_t b) noexcept { return { { a.Value[0] * b, a.Value[1] * b, a.Value[2] * b, a.Value[3] * b } }; }
+	inline UInt64 operator^(UInt64 a, UInt64 b) noexcept { return { { a.Value[0] ^ b.Value[0], a.Value[1] ^ b.Value[1], a.Value[2] ^ b.Value[2], a.Value[3] ^ b.Value[3] } }; }
+	inline UInt64 operator>>(UInt64 a, int count) noexcept { return { { a.Value[0] >> count, a.Value[1] >> count, a.Value[2] >> count, a.Value[3] >> count } }; }
+
+	inline Int ToInt(UInt64 a) noexcept {
+		return { _mm_setr_epi32(static_cast<int32_t>(a.Value[0]), static_cast<int32_t>(a.Value[1]), static_cast<int32_t>(a.Value[2]), static_cast<int32_t>(a.Value[3])) };
+	}
+#else
+	constexpr size_t Width = 1;
+
+	struct Mask { bool Value; };
+
+	struct Int { int32_t Value; };
+
+	struct Float { float Value; };
+
+	inline Float Broadcast(float value) noexcept { return { value }; }
+	inline Float Load(const float* p) noexcept { return { *p }; }
+	inline void Store(float* p, Float value) noexcept { *p = value.Value; }
+
+	inline Int BroadcastInt(int32_t value) noexcept { return { value }; }
+	inline Int Load(const int32_t* p) noexcept { return { *p }; }
+	inline void Store(int32_t* p, Int value) noexcept { *p = value.Value; }
+
+	inline Int Iota() noexcept { return { 0 }; }
+
+	inline Mask LoadMask(const uint8_t* p) noexcept { return { *p != 0 }; }
+
+	inline Float operator+(Float a, Float b) noexcept { return { a.Value + b.Value }; }
+	inline Float operator-(Float a, Float b) noexcept { return { a.Value - b.Value }; }
+	inline Float operator*(Float a, Float b) noexcept { return { a.Value * b.Value }; }
+	inline Float operator/(Float a, Float b) noexcept { return { a.Value / b.Value }; }
+	inline Float Min(Float a, Float b) noexcept { return { b.Value < a.Value ? b.Value : a.Value }; }
+	inline Float Max(Float a, Float b) noexcept { return { a.Value < b.Value ? b.Value : a.Value }; }
+	inline Float Sqrt(Float a) noexcept { return { std::sqrt(a.Value) }; }
+	inline Float Floor(Float a) noexcept { return { std::floor(a.Value) }; }
+
+	inline Mask operator<(Float a, Float b) noexcept { return { a.Value < b.Value }; }
+	inline Mask operator<=(Float a, Float b) noexcept { return { a.Value <= b.Value }; }
+	inline Mask operator>(Float a, Float b) noexcept { return { a.Value > b.Value }; }
+	inline Mask operator>=(Float a, Float b) noexcept { return { a.Value >= b.Value }; }
+
+	inline Mask operator&(Mask a, Mask b) noexcept { return { a.Value && b.Value }; }
+	inline Mask operator|(Mask a, Mask b) noexcept { return { a.Value || b.Value }; }
+	inline Mask AndNot(Mask a, Mask b) noexcept { return { a.Value && !b.Value }; }
+	inline uint32_t ToBits(Mask a) noexcept { return a.Value; }
+
+	inline Float Select(Mask mask, Float a, Float b) noexcept { return mask.Value ? a : b; }
+	inline Int Select(Mask mask, Int a, Int b) noexcept { return mask.Value ? a : b; }
+
+	// Wrap on overflow like the vector lanes do.
+	inline Int operator+(Int a, Int b) noexcept { return { static_cast<int32_t>(static_cast<uint32_t>(a.Value) + static_cast<uint32_t>(b.Value)) }; }
+	inline Int operator*(Int a, Int b) noexcept { return { static_cast<int32_t>(static_cast<uint32_t>(a.Value) * static_cast<uint32_t>(b.Value)) }; }
+	inline Int operator&(Int a, Int b) noexcept { return { a.Value & b.Value }; }
+	inline Mask operator==(Int a, Int b) noexcept { return { a.Value == b.Value }; }
+
+	inline Int ToInt(Float a) noexcept { return { static_cast<int32_t>(a.Value) }; }
+	inline Float ToFloat(Int a) noexcept { return { static_cast<float>(a.Value) }; }
+
+	inline Float Gather(const float* base, Int indices) noexcept { return { base[indices.Value] }; }
+
+	struct UInt64 { uint64_t Value; };
+
+	inline UInt64 Load(const uint64_t* p) noexcept { return { *p }; }
+
+	inline UInt64 operator+(UInt64 a, uint64_t b) noexcept { return { a.Value + b }; }
+	inline UInt64 operator*(UInt64 a, uint64_t b) noexcept { return { a.Value * b }; }
+	inline UInt64 operator^(UInt64 a, UInt64 b) noexcept { return { a.Value ^ b.Value }; }
+	inline UInt64 operator>>(UInt64 a, int count) noexcept { return { a.Value >> count }; }
+
+	inline Int ToInt(UInt64 a) noexcept { return { static_cast<int32_t>(static_cast<uint32_t>(a.Value)) }; }
+#endif
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "TripleBuffer.h"
+
+#include "DurationSamples.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+// How far the wall-clock time between consecutive ticks strays from the simulated time each tick advanced.
+class TickJitter {
+public:
+	void Record(std::chrono::steady_clock::time_point time, double elapsedSeconds) {
+		if (m_lastTime != std::chrono::steady_clock::time_point{}) m_deviations.Record(std::abs(std::chrono::duration<double>(time - m_lastTime).count() - elapsedSeconds));
+		m_lastTime = time;
+	}
+
+	DurationSamples::Statistics GetStatistics() const { return m_deviations.GetStatistics(); }
+
+private:
+	std::chrono::steady_clock::time_point m_lastTime;
+
+	DurationSamples m_deviations;
+};
+
+// Calls update at a fixed rate on its own thread and publishes a snapshot captured after every call, so the thread
+// that renders never waits for the simulation and the simulation never waits for a slow present or a modal loop.
+// published runs once the snapshot can be acquired.
+// A thread that falls more than a tenth of a second behind skips ahead instead of catching up, as StepTimer does.
+template <typename TSnapshot>
+class SimulationThread {
+public:
+	template <typename TUpdate, typename TCapture, typename TPublished = void (*)()>
+	SimulationThread(double stepSeconds, const TSnapshot& initialSnapshot, TUpdate update, TCapture capture, TPublished published = [] {}) :
+		m_snapshots(initialSnapshot),
+		m_thread([this, stepSeconds, update, capture, published](std::stop_token stopToken) mutable {
+			const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(stepSeconds));
+			constexpr auto MaxLag = std::chrono::milliseconds(100);
+
+			for (auto next = std::chrono::steady_clock::now(); !stopToken.stop_requested();) {
+				std::this_thread::sleep_until(next += step);
+
+				if (const auto now = std::chrono::steady_clock::now(); now - next > MaxLag) next = now;
+
+				update(static_cast<float>(stepSeconds));
+
+				capture(m_snapshots.GetWriteBuffer());
+				m_snapshots.Publish();
+
+				published();
+			}
+		}) {}
+
+	// The latest snapshot, which stays unchanged until the next call.
+	const TSnapshot& AcquireSnapshot() noexcept {
+		m_snapshots.Acquire();
+		return m_snapshots.GetReadBuffer();
+	}
+
+private:
+	TripleBuffer<TSnapshot> m_snapshots;
+
+	std::jthread m_thread;
+};
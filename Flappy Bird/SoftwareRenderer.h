@@ -0,0 +1,208 @@
+#pragma once
+
+#include "Renderer.h"
+
+#include "Simd.h"
+
+#include <algorithm>
+#include <vector>
+
+// Draws into an RGBA8 buffer on the CPU, Simd::Width pixels at a time, so frames can be rendered without a GPU or
+// a window. Coverage is sampled once at each pixel center without antialiasing. Rows are padded to a multiple of
+// Simd::Width pixels.
+class SoftwareRenderer : public IRenderer {
+public:
+	SoftwareRenderer(uint32_t width, uint32_t height) { Resize(width, height); }
+
+	void Resize(uint32_t width, uint32_t height) {
+		m_width = width;
+		m_height = height;
+		m_stride = static_cast<uint32_t>((width + Simd::Width - 1) / Simd::Width * Simd::Width);
+		m_pixels.assign(static_cast<size_t>(m_stride) * height, 0);
+	}
+
+	uint32_t GetWidth() const noexcept { return m_width; }
+	uint32_t GetHeight() const noexcept { return m_height; }
+
+	// Pixels per row, including padding.
+	uint32_t GetStride() const noexcept { return m_stride; }
+
+	// Bytes R, G, B, A in memory order.
+	const uint32_t* GetPixels() const noexcept { return m_pixels.data(); }
+
+	uint32_t GetPixel(uint32_t x, uint32_t y) const noexcept { return m_pixels[static_cast<size_t>(y) * m_stride + x]; }
+
+	b2Vec2 GetSize() const override { return { static_cast<float>(m_width), static_cast<float>(m_height) }; }
+
+	void BeginFrame() override {}
+	void EndFrame() override {}
+
+	void DrawBackground() override {
+		const auto gradient = GetGradient(Brush::Background);
+		for (uint32_t y = 0; y < m_height; y++) {
+			const auto t = std::clamp((y + 0.5f) / m_height * gradient.End.y, 0.0f, 1.0f);
+			const auto color = Simd::BroadcastInt(static_cast<int32_t>(Lerp(gradient.StartRgb, gradient.EndRgb, t)));
+			const auto row = GetRow(y);
+			for (uint32_t x = 0; x < m_stride; x += Simd::Width) Simd::Store(row + x, color);
+		}
+	}
+
+	void FillRectangle(Brush brush, const Matrix3x2& transform) override { Fill<false>(brush, transform); }
+
+	void FillEllipse(Brush brush, const Matrix3x2& transform) override { Fill<true>(brush, transform); }
+
+	// A 5x7 pixel font scaled so capitals are 70% of the font size. Lowercase letters are drawn as capitals and
+	// characters without a glyph as spaces.
+	void RenderText(std::string_view text, float fontSize, float top, uint32_t rgb) override {
+		if (text.empty()) return;
+
+		const auto pixelSize = fontSize / 10;
+		const auto color = ToPixel(rgb);
+
+		auto left = (m_width - (text.size() * GlyphAdvance - 1) * pixelSize) / 2;
+		top += (fontSize - GlyphHeight * pixelSize) / 2;
+
+		for (const auto character : text) {
+			if (const auto glyph = FindGlyph(character)) {
+				for (int row = 0; row < GlyphHeight; row++) {
+					for (int column = 0; column < GlyphWidth; column++) {
+						if (glyph[row] >> (GlyphWidth - 1 - column) & 1) {
+							const auto x = left + column * pixelSize, y = top + row * pixelSize;
+							FillSolid(x, y, x + pixelSize, y + pixelSize, color);
+						}
+					}
+				}
+			}
+			left += GlyphAdvance * pixelSize;
+		}
+	}
+
+private:
+	static constexpr int GlyphWidth = 5, GlyphHeight = 7, GlyphAdvance = GlyphWidth + 1;
+
+	static constexpr uint8_t Glyphs[][GlyphHeight]{
+		{ 0x0e, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0e }, { 0x04, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x0e },
+		{ 0x0e, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1f }, { 0x1f, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0e },
+		{ 0x02, 0x06, 0x0a, 0x12, 0x1f, 0x02, 0x02 }, { 0x1f, 0x10, 0x1e, 0x01, 0x01, 0x11, 0x0e },
+		{ 0x06, 0x08, 0x10, 0x1e, 0x11, 0x11, 0x0e }, { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08 },
+		{ 0x0e, 0x11, 0x11, 0x0e, 0x11, 0x11, 0x0e }, { 0x0e, 0x11, 0x11, 0x0f, 0x01, 0x02, 0x0c },
+		{ 0x0e, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 }, { 0x1e, 0x11, 0x11, 0x1e, 0x11, 0x11, 0x1e },
+		{ 0x0e, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0e }, { 0x1c, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1c },
+		{ 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x1f }, { 0x1f, 0x10, 0x10, 0x1e, 0x10, 0x10, 0x10 },
+		{ 0x0e, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0f }, { 0x11, 0x11, 0x11, 0x1f, 0x11, 0x11, 0x11 },
+		{ 0x0e, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0e }, { 0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0c },
+		{ 0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11 }, { 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1f },
+		{ 0x11, 0x1b, 0x15, 0x15, 0x11, 0x11, 0x11 }, { 0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11 },
+		{ 0x0e, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, { 0x1e, 0x11, 0x11, 0x1e, 0x10, 0x10, 0x10 },
+		{ 0x0e, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0d }, { 0x1e, 0x11, 0x11, 0x1e, 0x14, 0x12, 0x11 },
+		{ 0x0f, 0x10, 0x10, 0x0e, 0x01, 0x01, 0x1e }, { 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04 },
+		{ 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0e }, { 0x11, 0x11, 0x11, 0x11, 0x11, 0x0a, 0x04 },
+		{ 0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0a }, { 0x11, 0x11, 0x0a, 0x04, 0x0a, 0x11, 0x11 },
+		{ 0x11, 0x11, 0x11, 0x0a, 0x04, 0x04, 0x04 }, { 0x1f, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1f },
+		{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x0c, 0x0c }
+	};
+
+	uint32_t m_width{}, m_height{}, m_stride{};
+
+	std::vector<uint32_t> m_pixels;
+
+	static const uint8_t* FindGlyph(char character) noexcept {
+		if (character >= '0' && character <= '9') return Glyphs[character - '0'];
+		if (character >= 'A' && character <= 'Z') return Glyphs[10 + character - 'A'];
+		if (character >= 'a' && character <= 'z') return Glyphs[10 + character - 'a'];
+		if (character == '.') return Glyphs[36];
+		return nullptr;
+	}
+
+	static uint32_t ToPixel(uint32_t rgb) noexcept { return 0xff000000 | (rgb >> 16 & 0xff) | (rgb & 0xff00) | (rgb & 0xff) << 16; }
+
+	static uint32_t Lerp(uint32_t startRgb, uint32_t endRgb, float t) noexcept {
+		const auto Channel = [&](int shift) {
+			const auto start = static_cast<float>(startRgb >> shift & 0xff), end = static_cast<float>(endRgb >> shift & 0xff);
+			return static_cast<uint32_t>(start + (end - start) * t + 0.5f) << shift;
+		};
+		return ToPixel(Channel(16) | Channel(8) | Channel(0));
+	}
+
+	int32_t* GetRow(uint32_t y) noexcept { return reinterpret_cast<int32_t*>(m_pixels.data() + static_cast<size_t>(y) * m_stride); }
+
+	// Pixels whose centers fall in [left, right) x [top, bottom), clipped to the output, as integer bounds.
+	bool GetPixelBounds(float left, float top, float right, float bottom, uint32_t& x0, uint32_t& y0, uint32_t& x1, uint32_t& y1) const noexcept {
+		const auto Clamp = [](float value, uint32_t max) { return static_cast<uint32_t>(std::clamp(std::ceil(value - 0.5f), 0.0f, static_cast<float>(max))); };
+		x0 = Clamp(left, m_width);
+		x1 = Clamp(right, m_width);
+		y0 = Clamp(top, m_height);
+		y1 = Clamp(bottom, m_height);
+		return x0 < x1 && y0 < y1;
+	}
+
+	void FillSolid(float left, float top, float right, float bottom, uint32_t pixel) noexcept {
+		uint32_t x0, y0, x1, y1;
+		if (!GetPixelBounds(left, top, right, bottom, x0, y0, x1, y1)) return;
+
+		for (auto y = y0; y < y1; y++) std::fill(m_pixels.begin() + static_cast<size_t>(y) * m_stride + x0, m_pixels.begin() + static_cast<size_t>(y) * m_stride + x1, pixel);
+	}
+
+	// Walks the screen bounds of the transformed unit square, maps each pixel center back into it and shades the
+	// covered lanes with the brush gradient evaluated there.
+	template <bool IsEllipse>
+	void Fill(Brush brush, const Matrix3x2& transform) noexcept {
+		using namespace Simd;
+
+		b2Vec2 min{ INFINITY, INFINITY }, max{ -INFINITY, -INFINITY };
+		for (const b2Vec2 corner : { b2Vec2{ 0, 0 }, b2Vec2{ 1, 0 }, b2Vec2{ 0, 1 }, b2Vec2{ 1, 1 } }) {
+			const auto point = transform.TransformPoint(corner);
+			min = { std::min(min.x, point.x), std::min(min.y, point.y) };
+			max = { std::max(max.x, point.x), std::max(max.y, point.y) };
+		}
+
+		uint32_t x0, y0, x1, y1;
+		if (!GetPixelBounds(min.x, min.y, max.x, max.y, x0, y0, x1, y1)) return;
+		x0 = x0 / Width * Width;
+
+		const auto inverse = transform.Inverse();
+		const auto gradient = GetGradient(brush);
+		const auto gradientScale = 1 / (gradient.End.x * gradient.End.x + gradient.End.y * gradient.End.y);
+
+		const auto Channel = [](uint32_t rgb, int shift) { return static_cast<float>(rgb >> shift & 0xff); };
+		const Float
+			startR = Broadcast(Channel(gradient.StartRgb, 16)), deltaR = Broadcast(Channel(gradient.EndRgb, 16) - Channel(gradient.StartRgb, 16)),
+			startG = Broadcast(Channel(gradient.StartRgb, 8)), deltaG = Broadcast(Channel(gradient.EndRgb, 8) - Channel(gradient.StartRgb, 8)),
+			startB = Broadcast(Channel(gradient.StartRgb, 0)), deltaB = Broadcast(Channel(gradient.EndRgb, 0) - Channel(gradient.StartRgb, 0));
+
+		const auto zero = Broadcast(0), one = Broadcast(1), half = Broadcast(0.5f), quarter = Broadcast(0.25f);
+		const auto lane = ToFloat(Iota());
+		const auto du = Broadcast(inverse.M11), dv = Broadcast(inverse.M12);
+		const auto right = Broadcast(static_cast<float>(x1));
+		const auto alpha = BroadcastInt(static_cast<int32_t>(0xff000000)), green = BroadcastInt(1 << 8), blue = BroadcastInt(1 << 16);
+
+		for (auto y = y0; y < y1; y++) {
+			const auto row = GetRow(y);
+			const auto centerY = y + 0.5f;
+
+			for (auto x = x0; x < x1; x += static_cast<uint32_t>(Width)) {
+				const auto centerX = static_cast<float>(x) + 0.5f;
+				const auto u = Broadcast(centerX * inverse.M11 + centerY * inverse.M21 + inverse.Dx) + du * lane;
+				const auto v = Broadcast(centerX * inverse.M12 + centerY * inverse.M22 + inverse.Dy) + dv * lane;
+
+				auto covered = Broadcast(centerX - 0.5f) + lane < right;
+				if constexpr (IsEllipse) {
+					const auto cu = u - half, cv = v - half;
+					covered = covered & (cu * cu + cv * cv < quarter);
+				}
+				else covered = covered & (u >= zero) & (u < one) & (v >= zero) & (v < one);
+
+				if (!ToBits(covered)) continue;
+
+				const auto t = Min(Max((u * Broadcast(gradient.End.x) + v * Broadcast(gradient.End.y)) * Broadcast(gradientScale), zero), one);
+				const auto pixel =
+					ToInt(startR + deltaR * t + half) +
+					ToInt(startG + deltaG * t + half) * green +
+					ToInt(startB + deltaB * t + half) * blue +
+					alpha;
+
+				Store(row + x, Select(covered, pixel, Load(row + x)));
+			}
+		}
+	}
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Bounded lock-free queue for one producer thread and one consumer thread. Each side caches the other's index and
+// only reloads it when the queue looks full or empty, so the shared cache lines are touched once per batch.
+template <typename T, size_t Capacity>
+class SpscQueue {
+	static_assert(Capacity && !(Capacity & (Capacity - 1)), "Capacity must be a power of two");
+
+public:
+	// Returns false, dropping value, when the queue is full.
+	bool TryPush(const T& value) noexcept {
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		if (tail - m_cachedHead == Capacity) {
+			m_cachedHead = m_head.load(std::memory_order_acquire);
+			if (tail - m_cachedHead == Capacity) return false;
+		}
+
+		m_values[tail % Capacity] = value;
+		m_tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool TryPop(T& value) noexcept { return TryPopIf(value, [](const T&) { return true; }); }
+
+	// Pops the front value only if predicate accepts it, and otherwise leaves it at the front.
+	template <typename TPredicate>
+	bool TryPopIf(T& value, TPredicate predicate) noexcept {
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if (head == m_cachedTail) {
+			m_cachedTail = m_tail.load(std::memory_order_acquire);
+			if (head == m_cachedTail) return false;
+		}
+
+		if (!predicate(m_values[head % Capacity])) return false;
+
+		value = m_values[head % Capacity];
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+private:
+	alignas(64) std::atomic<size_t> m_head{};
+	size_t m_cachedTail{};
+
+	alignas(64) std::atomic<size_t> m_tail{};
+	size_t m_cachedHead{};
+
+	alignas(64) std::array<T, Capacity> m_values{};
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Incremental 64-bit FNV-1a over plain values. Add fields one at a time rather than whole structs so padding never
+// leaks into the hash.
+class StateHash {
+public:
+	static constexpr uint64_t OffsetBasis = 14695981039346656037ull, Prime = 1099511628211ull;
+
+	StateHash() = default;
+
+	explicit StateHash(uint64_t value) noexcept : m_value(value) {}
+
+	template <typename T> requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+	StateHash& Add(T value) noexcept {
+		unsigned char bytes[sizeof(value)];
+		std::memcpy(bytes, &value, sizeof(value));
+		for (const auto byte : bytes) m_value = (m_value ^ byte) * Prime;
+		return *this;
+	}
+
+	uint64_t Get() const noexcept { return m_value; }
+
+private:
+	uint64_t m_value = OffsetBasis;
+};
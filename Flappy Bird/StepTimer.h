@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <exception>
@@ -11,35 +12,90 @@
 
 namespace DX
 {
+#ifdef _WIN32
+    // Reads QueryPerformanceCounter.
+    class QpcClock
+    {
+    public:
+        uint64_t GetFrequency() const
+        {
+            LARGE_INTEGER frequency;
+            if (!QueryPerformanceFrequency(&frequency))
+            {
+                throw std::exception();
+            }
+            return static_cast<uint64_t>(frequency.QuadPart);
+        }
+
+        uint64_t GetCounter() const
+        {
+            LARGE_INTEGER counter;
+            if (!QueryPerformanceCounter(&counter))
+            {
+                throw std::exception();
+            }
+            return static_cast<uint64_t>(counter.QuadPart);
+        }
+    };
+#endif
+
+    // Reads std::chrono::steady_clock, for platforms without QPC.
+    class SteadyClock
+    {
+    public:
+        uint64_t GetFrequency() const noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::period::den / std::chrono::steady_clock::period::num);
+        }
+
+        uint64_t GetCounter() const noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+        }
+    };
+
+    // Only moves when advanced, so a headless run can tick as fast as it can simulate.
+    class VirtualClock
+    {
+    public:
+        static constexpr uint64_t Frequency = 10000000;
+
+        uint64_t GetFrequency() const noexcept { return Frequency; }
+        uint64_t GetCounter() const noexcept { return m_counter; }
+
+        void Advance(uint64_t counts) noexcept { m_counter += counts; }
+        void AdvanceSeconds(double seconds) noexcept { m_counter += static_cast<uint64_t>(seconds * Frequency); }
+
+    private:
+        uint64_t m_counter = 0;
+    };
+
     // Helper class for animation and simulation timing.
-    class StepTimer
+    template<typename TClock>
+    class BasicStepTimer
     {
     public:
-        StepTimer() noexcept(false) :
+        explicit BasicStepTimer(TClock clock = {}) noexcept(false) :
+            m_clock(clock),
             m_elapsedTicks(0),
             m_totalTicks(0),
             m_leftOverTicks(0),
             m_frameCount(0),
             m_framesPerSecond(0),
             m_framesThisSecond(0),
-            m_qpcSecondCounter(0),
+            m_clockSecondCounter(0),
             m_isFixedTimeStep(false),
             m_targetElapsedTicks(TicksPerSecond / 60)
         {
-            if (!QueryPerformanceFrequency(&m_qpcFrequency))
-            {
-                throw std::exception();
-            }
-
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
-            {
-                throw std::exception();
-            }
+            m_clockFrequency = m_clock.GetFrequency();
+            m_clockLastTime = m_clock.GetCounter();
 
             // Initialize max delta to 1/10 of a second.
-            m_qpcMaxDelta = static_cast<uint64_t>(m_qpcFrequency.QuadPart / 10);
+            m_clockMaxDelta = m_clockFrequency / 10;
         }
 
+        TClock& GetClock() noexcept { return m_clock; }
+
         // Get elapsed time since the previous Update call.
         uint64_t GetElapsedTicks() const noexcept { return m_elapsedTicks; }
         double GetElapsedSeconds() const noexcept { return TicksToSeconds(m_elapsedTicks); }
@@ -54,6 +110,13 @@ namespace DX
         // Get the current framerate.
         uint32_t GetFramesPerSecond() const noexcept { return m_framesPerSecond; }
 
+        // Get how far the time left over after the last fixed step is toward the next one, from 0 to 1. Rendering
+        // this far between the last two states hides the step rate. Always 1 in variable timestep mode.
+        double GetInterpolationFactor() const noexcept
+        {
+            return m_isFixedTimeStep ? static_cast<double>(m_leftOverTicks) / static_cast<double>(m_targetElapsedTicks) : 1;
+        }
+
         // Set whether to use fixed or variable timestep mode.
         void SetFixedTimeStep(bool isFixedTimestep) noexcept { m_isFixedTimeStep = isFixedTimestep; }
 
@@ -73,15 +136,12 @@ namespace DX
 
         void ResetElapsedTime()
         {
-            if (!QueryPerformanceCounter(&m_qpcLastTime))
-            {
-                throw std::exception();
-            }
+            m_clockLastTime = m_clock.GetCounter();
 
             m_leftOverTicks = 0;
             m_framesPerSecond = 0;
             m_framesThisSecond = 0;
-            m_qpcSecondCounter = 0;
+            m_clockSecondCounter = 0;
         }
 
         // Update timer state, calling the specified Update function the appropriate number of times.
@@ -89,27 +149,22 @@ namespace DX
         void Tick(const TUpdate& update)
         {
             // Query the current time.
-            LARGE_INTEGER currentTime;
+            const uint64_t currentTime = m_clock.GetCounter();
 
-            if (!QueryPerformanceCounter(&currentTime))
-            {
-                throw std::exception();
-            }
+            uint64_t timeDelta = currentTime - m_clockLastTime;
 
-            uint64_t timeDelta = static_cast<uint64_t>(currentTime.QuadPart - m_qpcLastTime.QuadPart);
-
-            m_qpcLastTime = currentTime;
-            m_qpcSecondCounter += timeDelta;
+            m_clockLastTime = currentTime;
+            m_clockSecondCounter += timeDelta;
 
             // Clamp excessively large time deltas (e.g. after paused in the debugger).
-            if (timeDelta > m_qpcMaxDelta)
+            if (timeDelta > m_clockMaxDelta)
             {
-                timeDelta = m_qpcMaxDelta;
+                timeDelta = m_clockMaxDelta;
             }
 
-            // Convert QPC units into a canonical tick format. This cannot overflow due to the previous clamp.
+            // Convert clock units into a canonical tick format. This cannot overflow due to the previous clamp.
             timeDelta *= TicksPerSecond;
-            timeDelta /= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+            timeDelta /= m_clockFrequency;
 
             const uint32_t lastFrameCount = m_frameCount;
 
@@ -158,19 +213,21 @@ namespace DX
                 m_framesThisSecond++;
             }
 
-            if (m_qpcSecondCounter >= static_cast<uint64_t>(m_qpcFrequency.QuadPart))
+            if (m_clockSecondCounter >= m_clockFrequency)
             {
                 m_framesPerSecond = m_framesThisSecond;
                 m_framesThisSecond = 0;
-                m_qpcSecondCounter %= static_cast<uint64_t>(m_qpcFrequency.QuadPart);
+                m_clockSecondCounter %= m_clockFrequency;
             }
         }
 
     private:
-        // Source timing data uses QPC units.
-        LARGE_INTEGER m_qpcFrequency;
-        LARGE_INTEGER m_qpcLastTime;
-        uint64_t m_qpcMaxDelta;
+        TClock m_clock;
+
+        // Source timing data uses clock units.
+        uint64_t m_clockFrequency;
+        uint64_t m_clockLastTime;
+        uint64_t m_clockMaxDelta;
 
         // Derived timing data uses a canonical tick format.
         uint64_t m_elapsedTicks;
@@ -181,10 +238,16 @@ namespace DX
         uint32_t m_frameCount;
         uint32_t m_framesPerSecond;
         uint32_t m_framesThisSecond;
-        uint64_t m_qpcSecondCounter;
+        uint64_t m_clockSecondCounter;
 
         // Members for configuring fixed timestep mode.
         bool m_isFixedTimeStep;
         uint64_t m_targetElapsedTicks;
     };
+
+#ifdef _WIN32
+    using StepTimer = BasicStepTimer<QpcClock>;
+#else
+    using StepTimer = BasicStepTimer<SteadyClock>;
+#endif
 }
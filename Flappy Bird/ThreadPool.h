@@ -0,0 +1,165 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool of worker threads that runs batches of indexed jobs.
+// Every worker owns a contiguous range of the batch and consumes it from the front; a worker that runs dry steals
+// the back half of another worker's remaining range, so batches with very uneven job lengths still keep every core busy.
+// A worker that finds nothing left to claim or steal sleeps until the next batch instead of waiting for the others.
+class ThreadPool {
+public:
+	explicit ThreadPool(uint32_t threadCount = std::thread::hardware_concurrency()) : m_workers(std::max(threadCount, 1u)) {
+		m_threads.reserve(m_workers.size() - 1);
+		for (uint32_t i = 1; i < m_workers.size(); i++) m_threads.emplace_back([this, i] { WorkerMain(i); });
+	}
+
+	~ThreadPool() {
+		{
+			const std::scoped_lock lock(m_mutex);
+			m_isStopping = true;
+		}
+		m_batchStarted.notify_all();
+
+		for (auto& thread : m_threads) thread.join();
+	}
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	uint32_t GetThreadCount() const noexcept { return static_cast<uint32_t>(m_workers.size()); }
+
+	// Calls job(index, workerIndex) for every index in [0, count) and blocks until all of them have returned.
+	// The calling thread takes part as worker 0.
+	template <typename TJob>
+	void Run(uint64_t count, const TJob& job) {
+		if (!count) return;
+
+		{
+			const std::scoped_lock lock(m_mutex);
+
+			const auto workerCount = static_cast<uint64_t>(m_workers.size());
+			for (uint64_t i = 0; i < workerCount; i++) {
+				auto& worker = m_workers[i];
+				const std::scoped_lock workerLock(worker.Mutex);
+				worker.Begin = count * i / workerCount;
+				worker.End = count * (i + 1) / workerCount;
+			}
+
+			m_job = [&job](uint64_t index, uint32_t workerIndex) { job(index, workerIndex); };
+			m_unclaimedCount = count;
+			m_busyCount = static_cast<uint32_t>(m_threads.size());
+			m_batch++;
+		}
+		m_batchStarted.notify_all();
+
+		RunJobs(0);
+
+		std::unique_lock lock(m_mutex);
+		m_batchFinished.wait(lock, [&] { return !m_busyCount; });
+		m_job = nullptr;
+	}
+
+private:
+	struct alignas(64) Worker {
+		std::mutex Mutex;
+		uint64_t Begin{}, End{};
+	};
+	std::vector<Worker> m_workers;
+
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_mutex;
+	std::condition_variable m_batchStarted, m_batchFinished;
+	bool m_isStopping{};
+	uint64_t m_batch{};
+	uint32_t m_busyCount{};
+	std::atomic<uint64_t> m_unclaimedCount{};
+
+	std::function<void(uint64_t, uint32_t)> m_job;
+
+	void WorkerMain(uint32_t workerIndex) {
+		uint64_t batch = 0;
+		while (true) {
+			{
+				std::unique_lock lock(m_mutex);
+				m_batchStarted.wait(lock, [&] { return m_isStopping || m_batch != batch; });
+				if (m_isStopping) return;
+				batch = m_batch;
+			}
+
+			RunJobs(workerIndex);
+
+			{
+				const std::scoped_lock lock(m_mutex);
+				if (--m_busyCount) continue;
+			}
+			m_batchFinished.notify_one();
+		}
+	}
+
+	void RunJobs(uint32_t workerIndex) {
+		auto& worker = m_workers[workerIndex];
+
+		while (true) {
+			uint64_t index;
+			{
+				const std::scoped_lock lock(worker.Mutex);
+				if (worker.Begin != worker.End) index = worker.Begin++;
+				else index = UINT64_MAX;
+			}
+
+			if (index == UINT64_MAX) {
+				if (Steal(workerIndex)) continue;
+
+				// Every job has been claimed and the batch only waits for the ones still running. Jobs stay unclaimed
+				// only for the moment a steal carries them from one range to another.
+				if (!m_unclaimedCount.load(std::memory_order_relaxed)) return;
+
+				std::this_thread::yield();
+				continue;
+			}
+
+			m_unclaimedCount.fetch_sub(1, std::memory_order_relaxed);
+			m_job(index, workerIndex);
+		}
+	}
+
+	bool Steal(uint32_t workerIndex) {
+		auto& thief = m_workers[workerIndex];
+
+		for (uint32_t i = 1; i < m_workers.size(); i++) {
+			auto& victim = m_workers[(workerIndex + i) % m_workers.size()];
+
+			uint64_t begin, end;
+			{
+				const std::scoped_lock lock(victim.Mutex);
+				if (victim.End - victim.Begin < 2) {
+					if (victim.Begin == victim.End) continue;
+
+					begin = victim.Begin++;
+					end = begin + 1;
+				}
+				else {
+					begin = victim.Begin + (victim.End - victim.Begin) / 2;
+					end = victim.End;
+					victim.End = begin;
+				}
+			}
+
+			const std::scoped_lock lock(thief.Mutex);
+			thief.Begin = begin;
+			thief.End = end;
+			return true;
+		}
+
+		return false;
+	}
+};
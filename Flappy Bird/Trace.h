@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Scoped timing zones, recorded only when FLAPPY_BIRD_ENABLE_TRACING is defined. Otherwise TRACE_ZONE expands to
+// nothing and the rest of this header is never called. With FLAPPY_BIRD_TRACK_ALLOCATIONS, every zone is also an
+// AllocationTracker phase.
+#define TRACE_CONCATENATE_(a, b) a##b
+#define TRACE_CONCATENATE(a, b) TRACE_CONCATENATE_(a, b)
+
+#ifdef FLAPPY_BIRD_ENABLE_TRACING
+#define TRACE_ZONE_TIMING(name) const Trace::Zone TRACE_CONCATENATE(traceZone, __LINE__)(name)
+#else
+#define TRACE_ZONE_TIMING(name) static_cast<void>(0)
+#endif
+
+#ifdef FLAPPY_BIRD_TRACK_ALLOCATIONS
+#include "AllocationTracker.h"
+
+#define TRACE_ZONE_ALLOCATIONS(name) const AllocationTracker::Phase TRACE_CONCATENATE(allocationPhase, __LINE__)(name)
+#else
+#define TRACE_ZONE_ALLOCATIONS(name) static_cast<void>(0)
+#endif
+
+#define TRACE_ZONE(name) TRACE_ZONE_TIMING(name); TRACE_ZONE_ALLOCATIONS(name)
+
+namespace Trace {
+	struct Event {
+		const char* Name;
+		uint32_t ThreadIndex;
+		int64_t BeginNanoseconds, EndNanoseconds;
+	};
+
+	struct ZoneStatistics {
+		std::string_view Name;
+		size_t Count;
+		double P50Microseconds, P99Microseconds, MaxMicroseconds;
+	};
+
+	// Each thread writes only to its own ring and publishes with a release store of its event count, so recording
+	// never locks. The oldest events are overwritten once a ring is full. Every slot is a seqlock: its sequence is odd
+	// while the owner writes it and tells which event it holds, so a reader keeps only copies that nothing overwrote.
+	class Buffer {
+	public:
+		static constexpr size_t Capacity = 1 << 16;
+
+		explicit Buffer(uint32_t threadIndex) noexcept : m_threadIndex(threadIndex) {}
+
+		void Write(const char* name, int64_t beginNanoseconds, int64_t endNanoseconds) noexcept {
+			const auto count = m_count.load(std::memory_order_relaxed);
+			auto& slot = m_slots[count % Capacity];
+
+			slot.Sequence.store(count * 2 + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.Name.store(name, std::memory_order_relaxed);
+			slot.BeginNanoseconds.store(beginNanoseconds, std::memory_order_relaxed);
+			slot.EndNanoseconds.store(endNanoseconds, std::memory_order_relaxed);
+			slot.Sequence.store(count * 2 + 2, std::memory_order_release);
+
+			m_count.store(count + 1, std::memory_order_release);
+		}
+
+		// Copies the retained events, from any thread while the owner keeps writing, dropping those it overwrote meanwhile.
+		void Read(std::vector<Event>& events) const {
+			const auto count = m_count.load(std::memory_order_acquire);
+			for (auto i = count > Capacity ? count - Capacity : 0; i < count; i++) {
+				const auto& slot = m_slots[i % Capacity];
+				const auto sequence = i * 2 + 2;
+				if (slot.Sequence.load(std::memory_order_acquire) != sequence) continue;
+
+				const Event event{ slot.Name.load(std::memory_order_relaxed), m_threadIndex, slot.BeginNanoseconds.load(std::memory_order_relaxed), slot.EndNanoseconds.load(std::memory_order_relaxed) };
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (slot.Sequence.load(std::memory_order_relaxed) == sequence) events.emplace_back(event);
+			}
+		}
+
+	private:
+		struct Slot {
+			std::atomic<uint64_t> Sequence{};
+			std::atomic<const char*> Name{};
+			std::atomic<int64_t> BeginNanoseconds{}, EndNanoseconds{};
+		};
+
+		const uint32_t m_threadIndex;
+
+		std::atomic<uint64_t> m_count{};
+
+		std::array<Slot, Capacity> m_slots;
+	};
+
+	// Buffers outlive their threads so that zones recorded by finished workers can still be exported.
+	struct Registry {
+		std::mutex Mutex;
+		std::vector<std::shared_ptr<Buffer>> Buffers;
+
+		const std::chrono::steady_clock::time_point Epoch = std::chrono::steady_clock::now();
+
+		static Registry& Get() {
+			static Registry registry;
+			return registry;
+		}
+	};
+
+	inline Buffer& GetThreadBuffer() {
+		thread_local const auto buffer = [] {
+			auto& registry = Registry::Get();
+			const std::scoped_lock lock(registry.Mutex);
+			return registry.Buffers.emplace_back(std::make_shared<Buffer>(static_cast<uint32_t>(registry.Buffers.size())));
+		}();
+		return *buffer;
+	}
+
+	inline int64_t GetNanoseconds() noexcept {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Registry::Get().Epoch).count();
+	}
+
+	class Zone {
+	public:
+		explicit Zone(const char* name) noexcept : m_name(name), m_beginNanoseconds(GetNanoseconds()) {}
+
+		~Zone() { GetThreadBuffer().Write(m_name, m_beginNanoseconds, GetNanoseconds()); }
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+	private:
+		const char* const m_name;
+		const int64_t m_beginNanoseconds;
+	};
+
+	inline std::vector<Event> Collect() {
+		auto& registry = Registry::Get();
+		const std::scoped_lock lock(registry.Mutex);
+
+		std::vector<Event> events;
+		for (const auto& buffer : registry.Buffers) buffer->Read(events);
+		return events;
+	}
+
+	// Nearest-rank percentiles of each zone's duration, by zone name.
+	inline std::vector<ZoneStatistics> GetStatistics(const std::vector<Event>& events) {
+		std::map<std::string_view, std::vector<int64_t>> durations;
+		for (const auto& event : events) durations[event.Name].emplace_back(event.EndNanoseconds - event.BeginNanoseconds);
+
+		std::vector<ZoneStatistics> statistics;
+		for (auto& [name, values] : durations) {
+			std::sort(values.begin(), values.end());
+			const auto Percentile = [&](double fraction) { return values[static_cast<size_t>(fraction * (values.size() - 1) + 0.5)] / 1e3; };
+			statistics.push_back({ name, values.size(), Percentile(0.5), Percentile(0.99), values.back() / 1e3 });
+		}
+		return statistics;
+	}
+
+	// Complete ("X") events in the Chrome trace event format, which chrome://tracing and Perfetto open directly.
+	inline void WriteChromeJson(std::ostream& stream, const std::vector<Event>& events) {
+		const auto flags = stream.flags();
+		const auto precision = stream.precision(3);
+		stream << std::fixed << "{\"traceEvents\":[";
+		for (size_t i = 0; i < events.size(); i++) {
+			const auto& event = events[i];
+			stream << (i ? ",\n" : "\n") << "{\"name\":\"";
+			for (auto name = event.Name; *name; name++) {
+				if (*name == '"' || *name == '\\') stream << '\\';
+				stream << *name;
+			}
+			stream << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.ThreadIndex
+				<< ",\"ts\":" << event.BeginNanoseconds / 1e3 << ",\"dur\":" << (event.EndNanoseconds - event.BeginNanoseconds) / 1e3 << '}';
+		}
+		stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		stream.flags(flags);
+		stream.precision(precision);
+	}
+
+	inline void WriteStatistics(std::ostream& stream, const std::vector<Event>& events) {
+		for (const auto& [name, count, p50, p99, max] : GetStatistics(events)) {
+			stream << name << ": " << count << " zones, p50 " << p50 << " us, p99 " << p99 << " us, max " << max << " us\n";
+		}
+	}
+}
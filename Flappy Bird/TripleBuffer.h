@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Hands the latest value from one writer thread to one reader thread without locks or waiting. The writer fills
+// GetWriteBuffer() and publishes it; the reader acquires whatever was published last, and a value the reader holds is
+// never written until it acquires another.
+template <typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() = default;
+
+	explicit TripleBuffer(const T& value) : m_buffers{ value, value, value } {}
+
+	T& GetWriteBuffer() noexcept { return m_buffers[m_writeIndex]; }
+
+	void Publish() noexcept { m_writeIndex = m_middle.exchange(m_writeIndex | DirtyBit, std::memory_order_acq_rel) & IndexMask; }
+
+	// Returns whether a value was published since the last call.
+	bool Acquire() noexcept {
+		if (!(m_middle.load(std::memory_order_relaxed) & DirtyBit)) return false;
+
+		m_readIndex = m_middle.exchange(m_readIndex, std::memory_order_acq_rel) & IndexMask;
+		return true;
+	}
+
+	const T& GetReadBuffer() const noexcept { return m_buffers[m_readIndex]; }
+
+private:
+	static constexpr uint8_t IndexMask = 3, DirtyBit = 4;
+
+	std::array<T, 3> m_buffers{};
+
+	alignas(64) uint8_t m_writeIndex = 0;
+
+	alignas(64) std::atomic<uint8_t> m_middle = 1;
+
+	alignas(64) uint8_t m_readIndex = 2;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+// Box2D 2.4's default settings with b2Alloc and b2Free counted by AllocationTracker. Box2D includes this instead of
+// its defaults when it is built with BOX2D_USER_SETTINGS and this directory on its include path; the game and Box2D
+// must then agree on it, which the PUBLIC B2_USER_SETTINGS definition on the box2d target takes care of.
+
+#include "AllocationTracker.h"
+
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#define b2_lengthUnitsPerMeter 1.0f
+
+#define b2_maxPolygonVertices 8
+
+struct B2_API b2BodyUserData {
+	uintptr_t pointer = 0;
+};
+
+struct B2_API b2FixtureUserData {
+	uintptr_t pointer = 0;
+};
+
+struct B2_API b2JointUserData {
+	uintptr_t pointer = 0;
+};
+
+inline void* b2Alloc(int32 size) {
+	AllocationTracker::RecordAllocation(static_cast<size_t>(size));
+	return std::malloc(static_cast<size_t>(size));
+}
+
+inline void b2Free(void* mem) {
+	if (mem == nullptr) return;
+
+	AllocationTracker::RecordFree();
+	std::free(mem);
+}
+
+inline void b2Log(const char* string, ...) {
+	va_list args;
+	va_start(args, string);
+	std::vprintf(string, args);
+	va_end(args);
+}
@@ -18,7 +18,7 @@
 #include <Windows.h>
 #include <windowsx.h>
 
-#include <d2d1_1.h>
+#include <d2d1_3.h>
 #include <dwrite.h>
 
 #include <wrl.h>
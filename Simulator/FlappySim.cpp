@@ -0,0 +1,144 @@
+// Plays headless episodes on a thread pool and prints throughput and the score distribution.
+
+#include "RolloutRunner.h"
+
+#include "Policies.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	struct Arguments {
+		uint64_t EpisodeCount = 1000;
+		uint32_t Seed = 0;
+		uint32_t ThreadCount = thread::hardware_concurrency();
+		uint32_t MaxTicks = 60 * 60 * 5;
+		string_view Policy = "autopilot";
+		float FlyUpProbability = 0.03f;
+		string_view Physics = "box2d";
+		float WorldWidth = 12 * 16 / 9.0f;
+	};
+
+	constexpr auto Usage =
+		"Usage: flappy-sim [options]\n"
+		"  --episodes=N          episodes to play (1000)\n"
+		"  --seed=S              episode i plays the course seeded S + i (0)\n"
+		"  --threads=N           worker threads, including the calling one (all cores)\n"
+		"  --ticks=N             tick budget per episode at 60 ticks per second (18000)\n"
+		"  --policy=NAME         autopilot or random (autopilot)\n"
+		"  --flap-probability=P  chance per tick that the random policy flies up (0.03)\n"
+		"  --physics=NAME        box2d or analytic (box2d)\n"
+		"  --world-width=W       world width in units, the height being 12 (21.33)\n";
+
+	template <typename T>
+	bool Parse(string_view text, T& value) {
+		const auto end = text.data() + text.size();
+		const auto [last, error] = from_chars(text.data(), end, value);
+		return error == errc() && last == end;
+	}
+
+	optional<Arguments> ParseArguments(int argc, char** argv) {
+		Arguments arguments;
+		for (auto i = 1; i < argc; i++) {
+			const string_view argument = argv[i];
+			const auto separator = argument.find('=');
+			if (separator == string_view::npos) return nullopt;
+
+			const auto name = argument.substr(0, separator), value = argument.substr(separator + 1);
+			bool isValid;
+			if (name == "--episodes") isValid = Parse(value, arguments.EpisodeCount);
+			else if (name == "--seed") isValid = Parse(value, arguments.Seed);
+			else if (name == "--threads") isValid = Parse(value, arguments.ThreadCount) && arguments.ThreadCount;
+			else if (name == "--ticks") isValid = Parse(value, arguments.MaxTicks);
+			else if (name == "--policy") isValid = (arguments.Policy = value) == "autopilot" || value == "random";
+			else if (name == "--flap-probability") isValid = Parse(value, arguments.FlyUpProbability);
+			else if (name == "--physics") isValid = (arguments.Physics = value) == "box2d" || value == "analytic";
+			else if (name == "--world-width") isValid = Parse(value, arguments.WorldWidth) && arguments.WorldWidth > 0;
+			else isValid = false;
+
+			if (!isValid) return nullopt;
+		}
+		return arguments;
+	}
+
+	void PrintResults(const RolloutStats& stats, vector<RolloutResult>& results) {
+		printf("%llu episodes on %u threads in %.3f s: %.0f episodes/s, %.0f ticks/s\n",
+			static_cast<unsigned long long>(stats.Episodes), stats.ThreadCount, stats.Seconds, stats.GetEpisodesPerSecond(), stats.GetStepsPerSecond());
+
+		if (results.empty()) return;
+
+		ranges::sort(results, {}, &RolloutResult::Score);
+
+		double sum = 0;
+		size_t unfinishedCount = 0;
+		for (const auto& result : results) {
+			sum += result.Score;
+			unfinishedCount += !result.IsOver;
+		}
+
+		const auto Percentile = [&](double fraction) { return results[static_cast<size_t>(fraction * (results.size() - 1) + 0.5)].Score; };
+		printf("Score: mean %.2f, min %u, p50 %u, p90 %u, p99 %u, max %u\n", sum / results.size(), results.front().Score, Percentile(0.5), Percentile(0.9), Percentile(0.99), results.back().Score);
+		printf("%zu episodes reached the tick budget\n", unfinishedCount);
+
+		// Scores of 0, then [1, 2), [2, 4), [4, 8) and so on.
+		vector<size_t> buckets;
+		for (const auto& result : results) {
+			const auto bucket = result.Score ? static_cast<size_t>(bit_width(result.Score)) : 0;
+			if (bucket >= buckets.size()) buckets.resize(bucket + 1);
+			buckets[bucket]++;
+		}
+
+		const auto maxCount = *ranges::max_element(buckets);
+		for (size_t bucket = 0; bucket < buckets.size(); bucket++) {
+			const auto low = bucket ? 1u << (bucket - 1) : 0, high = bucket ? (1u << bucket) - 1 : 0;
+			printf("%6u-%-6u %8zu %s\n", low, high, buckets[bucket], string(buckets[bucket] * 50 / maxCount, '#').c_str());
+		}
+	}
+
+	template <typename TGame, typename TPolicy>
+	void Run(const Arguments& arguments, const TPolicy& policy) {
+		RolloutRunner runner(arguments.ThreadCount);
+
+		RolloutRunner::Options options;
+		options.WorldWidth = arguments.WorldWidth;
+		options.MaxSteps = arguments.MaxTicks;
+		options.FirstSeed = arguments.Seed;
+
+		// A game only starts on its first flap.
+		const auto startingPolicy = [policy](const TGame& game) { return game.GetState() == TGame::State::NotStarted || policy(game); };
+
+		vector<RolloutResult> results;
+		const auto stats = runner.Run<TGame>(arguments.EpisodeCount, startingPolicy, options, &results);
+		PrintResults(stats, results);
+	}
+
+	template <typename TGame>
+	int Run(const Arguments& arguments) {
+		if (const auto barrierCount = TGame::GetRequiredBarrierCapacity(arguments.WorldWidth); barrierCount > TGame::Physics::MaxBarrierCount) {
+			fprintf(stderr, "A world %g units wide needs room for %zu barriers, and the %.*s physics has room for %zu.\n",
+				arguments.WorldWidth, barrierCount, static_cast<int>(arguments.Physics.size()), arguments.Physics.data(), TGame::Physics::MaxBarrierCount);
+			fputs(Usage, stderr);
+			return 2;
+		}
+
+		if (arguments.Policy == "random") Run<TGame>(arguments, RandomPolicy(arguments.FlyUpProbability, arguments.Seed));
+		else Run<TGame>(arguments, AutopilotPolicy());
+		return 0;
+	}
+}
+
+int main(int argc, char** argv) {
+	const auto arguments = ParseArguments(argc, argv);
+	if (!arguments) {
+		fputs(Usage, stderr);
+		return 2;
+	}
+
+	return arguments->Physics == "analytic" ? Run<AnalyticGame>(*arguments) : Run<Game>(*arguments);
+}
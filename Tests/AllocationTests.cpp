@@ -0,0 +1,31 @@
+//
+// AllocationTests.cpp - Checks that the simulation stops allocating once it has warmed up
+//
+
+#include "AllocationCheck.h"
+
+#include "Policies.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	template <typename TGame>
+	class AllocationTest : public testing::Test {};
+
+	using Games = testing::Types<Game, AnalyticGame>;
+	TYPED_TEST_SUITE(AllocationTest, Games);
+
+	// No Running tick allocates once the autopilot has played for ten seconds, restarting whenever it dies.
+	TYPED_TEST(AllocationTest, RunningTicksDoNotAllocate) {
+#ifdef FLAPPY_BIRD_TRACK_ALLOCATIONS
+		const auto trace = RecordTrace<TypeParam>(AutopilotPolicy(), 60 * 60);
+
+		const auto allocatingTick = FindSteadyStateAllocation<TypeParam>(trace, 60 * 10);
+		EXPECT_FALSE(allocatingTick) << "Running tick " << allocatingTick->Tick << " allocated " << allocatingTick->Counts.Bytes << " bytes";
+#else
+		GTEST_SKIP() << "Allocations are only counted with FLAPPY_BIRD_TRACK_ALLOCATIONS";
+#endif
+	}
+}
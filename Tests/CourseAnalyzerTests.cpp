@@ -0,0 +1,52 @@
+//
+// CourseAnalyzerTests.cpp - Checks that the analyzer screens the courses the game generates
+//
+
+#include "CourseAnalyzer.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	// Every lane of a vector draw is the draw a Random with that lane's key makes.
+	TEST(CourseAnalyzerTest, VectorDrawsMatchRandom) {
+		uint64_t keys[Simd::Width];
+		for (size_t lane = 0; lane < Simd::Width; lane++) keys[lane] = Random(static_cast<uint32_t>(lane * 977)).GetKey();
+
+		for (uint32_t index = 0; index < 100; index++) {
+			int32_t bits[Simd::Width];
+			Simd::Store(bits, Simd::ToInt(Random::GetBitsAt(Simd::Load(keys), index)));
+
+			for (size_t lane = 0; lane < Simd::Width; lane++) ASSERT_EQ(static_cast<uint64_t>(bits[lane]), Random::GetBitsAt(keys[lane], index)) << "Lane " << lane << ", draw " << index;
+		}
+	}
+
+	// The gap bottoms are those of the game's course.
+	TEST(CourseAnalyzerTest, GapBottomsMatchTheGame) {
+		const CourseAnalyzer analyzer;
+
+		for (uint32_t seed = 0; seed < 10; seed++) {
+			const AnalyticGame game(12 * 16 / 9.0f, seed);
+			for (uint32_t barrier = 0; barrier < 20; barrier++) EXPECT_FLOAT_EQ(analyzer.GetGapBottom(seed, barrier), game.GetCourseGapBottom(barrier));
+		}
+	}
+
+	// A course gets the same margin in any lane, so each lane draws the course of its own seed.
+	TEST(CourseAnalyzerTest, MarginsDoNotDependOnLane) {
+		const CourseAnalyzer analyzer;
+
+		constexpr uint32_t FirstSeed = 1000, Count = 37;
+		float margins[Count];
+		uint32_t tightestBarriers[Count];
+		analyzer.Analyze(FirstSeed, Count, 50, margins, tightestBarriers);
+
+		for (uint32_t i = 0; i < Count; i++) {
+			float margin;
+			uint32_t tightestBarrier;
+			analyzer.Analyze(FirstSeed + i, 1, 50, &margin, &tightestBarrier);
+			EXPECT_EQ(margins[i], margin) << "Seed " << FirstSeed + i;
+			EXPECT_EQ(tightestBarriers[i], tightestBarrier) << "Seed " << FirstSeed + i;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+//
+// FlappyEnvTests.cpp - Checks that flappy-env's rewards and observations follow the game's own rules
+//
+
+#include "FlappyEnv.h"
+
+#include "Game.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Plays AnalyticGames next to an environment on the same seeds and the same random presses for a minute, resetting
+	// each game when its episode ends. Every step's rewards, done flags and observations must be what the game's
+	// Update, FlyUp and gap sensor scoring give.
+	TEST(FlappyEnvTest, StepsAsAnalyticGames) {
+		constexpr uint32_t Count = 61, Seed = 11, TickCount = 60 * 60;
+
+		const unique_ptr<flappy_env, decltype(&flappy_env_destroy)> env(flappy_env_create(Count, Seed), flappy_env_destroy);
+		ASSERT_NE(env, nullptr);
+		ASSERT_EQ(flappy_env_get_count(env.get()), Count);
+
+		vector<unique_ptr<AnalyticGame>> games;
+		for (uint32_t i = 0; i < Count; i++) games.emplace_back(make_unique<AnalyticGame>(12 * 16 / 9.0f, Seed + i));
+
+		const Random random(Seed);
+		vector<uint8_t> actions(Count), dones(Count);
+		vector<float> observations(Count * FLAPPY_ENV_OBSERVATION_SIZE), rewards(Count);
+		for (uint32_t tick = 0; tick < TickCount; tick++) {
+			for (uint32_t i = 0; i < Count; i++) actions[i] = random.FloatAt(static_cast<uint64_t>(tick) * Count + i) < 0.02f + 0.2f * i / (Count - 1);
+
+			flappy_env_step(env.get(), actions.data(), observations.data(), rewards.data(), dones.data());
+
+			for (uint32_t i = 0; i < Count; i++) {
+				auto& game = *games[i];
+				const auto score = game.GetScore();
+				if (actions[i]) game.FlyUp();
+				game.Update(1 / 60.0f);
+
+				const auto isOver = game.GetState() == AnalyticGame::State::Over;
+				ASSERT_EQ(dones[i], isOver) << "Game " << i << ", tick " << tick;
+				ASSERT_EQ(rewards[i], isOver ? -1.0f : static_cast<float>(game.GetScore() - score)) << "Game " << i << ", tick " << tick;
+				if (isOver) game.Reset();
+
+				const auto observation = &observations[i * FLAPPY_ENV_OBSERVATION_SIZE];
+				ASSERT_NEAR(observation[0], game.GetPawnPosition().y, 1e-3f) << "Game " << i << ", tick " << tick;
+				ASSERT_NEAR(observation[1], game.GetPawnLinearVelocity().y, 1e-3f) << "Game " << i << ", tick " << tick;
+
+				if (game.GetState() != AnalyticGame::State::Running) continue;
+
+				// The next barrier the pawn has not passed. The batch keeps one x per game and the game one per barrier, so
+				// barrier positions drift apart by rounding, and ticks where the pawn is about to pass a barrier are left
+				// out.
+				const auto& physics = game.GetPhysics();
+				const auto pawnPosition = game.GetPawnPosition();
+				const auto GetPassedDistance = [&](size_t index) { return pawnPosition.x - AnalyticGame::PawnRadius - (physics.GetBarrierPositionX(index) + AnalyticGame::BarrierWidth / 2); };
+				size_t barrierIndex = 0;
+				while (barrierIndex + 1 < physics.GetBarrierCount() && GetPassedDistance(barrierIndex) > 0) barrierIndex++;
+				if (abs(GetPassedDistance(barrierIndex)) < 1e-2f || (barrierIndex && abs(GetPassedDistance(barrierIndex - 1)) < 1e-2f)) continue;
+
+				const auto barrier = physics.GetBarrier(barrierIndex);
+				ASSERT_NEAR(observation[2], barrier.PositionX - pawnPosition.x, 1e-2f) << "Game " << i << ", tick " << tick;
+				ASSERT_EQ(observation[3], barrier.GapBottom) << "Game " << i << ", tick " << tick;
+				ASSERT_NEAR(observation[4], barrier.GapTop, 1e-5f) << "Game " << i << ", tick " << tick;
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+//
+// FramePacerTests.cpp - Checks the frame pacer's schedule on a virtual clock
+//
+
+#include "FramePacer.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	constexpr double FrameRate = 120, IdleFrameSeconds = 0.1;
+
+	using VirtualFramePacer = BasicFramePacer<DX::VirtualClock>;
+
+	// Frames a pacer begins over seconds, sleeping exactly as long as it asks between them.
+	uint64_t CountPacedFrames(VirtualFramePacer& pacer, double seconds) {
+		const auto end = pacer.GetClock().GetCounter() + static_cast<uint64_t>(seconds * DX::VirtualClock::Frequency);
+		const auto frameCount = pacer.GetFrameCount();
+		while (pacer.GetClock().GetCounter() < end) {
+			if (!pacer.TryBeginFrame()) pacer.GetClock().Advance(max<uint64_t>(static_cast<uint64_t>(pacer.GetSecondsUntilNextFrame() * DX::VirtualClock::Frequency), 1));
+		}
+		return pacer.GetFrameCount() - frameCount;
+	}
+
+	TEST(FramePacerTest, ActiveBeginsAFramePerFrameInterval) {
+		VirtualFramePacer pacer(1 / FrameRate, IdleFrameSeconds);
+
+		EXPECT_NEAR(static_cast<double>(CountPacedFrames(pacer, 1)), FrameRate, 1);
+	}
+
+	TEST(FramePacerTest, IdleBeginsAFramePerIdleInterval) {
+		VirtualFramePacer pacer(1 / FrameRate, IdleFrameSeconds);
+		CountPacedFrames(pacer, 1);
+
+		pacer.SetIdle(true);
+		EXPECT_NEAR(static_cast<double>(CountPacedFrames(pacer, 1)), 1 / IdleFrameSeconds, 1);
+	}
+
+	// A wake a third of the way to the next idle frame makes a frame due at once, and keeps the full rate for an idle
+	// interval.
+	TEST(FramePacerTest, WakeBringsTheNextFrameForward) {
+		VirtualFramePacer pacer(1 / FrameRate, IdleFrameSeconds);
+		pacer.SetIdle(true);
+		CountPacedFrames(pacer, 1);
+
+		pacer.TryBeginFrame();
+		pacer.GetClock().AdvanceSeconds(pacer.GetSecondsUntilNextFrame() / 3);
+		ASSERT_FALSE(pacer.TryBeginFrame()) << "Idle frame due early";
+
+		pacer.Wake();
+		EXPECT_EQ(pacer.GetSecondsUntilNextFrame(), 0);
+		EXPECT_TRUE(pacer.TryBeginFrame());
+		EXPECT_NEAR(static_cast<double>(CountPacedFrames(pacer, IdleFrameSeconds)), IdleFrameSeconds * FrameRate, 1);
+	}
+
+	// With a frame interval of 0 every call begins a frame.
+	TEST(FramePacerTest, ZeroFrameIntervalIsUnpaced) {
+		VirtualFramePacer pacer(0, 0);
+
+		for (auto i = 0; i < 10; i++) EXPECT_TRUE(pacer.TryBeginFrame());
+	}
+}
@@ -0,0 +1,52 @@
+//
+// GameBatchTests.cpp - Checks that GameBatch plays every lane exactly as AnalyticGame would
+//
+
+#include "GameBatch.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	constexpr float StepSeconds = 1 / 60.0f;
+
+	// Steps a batch and one AnalyticGame per lane on the same seeds and the same random presses, and compares state,
+	// score and pawn height lane by lane after every tick. Lanes press with chances from 1% to 25% per tick, so some
+	// die early, some play on, and some fly over the world and the barriers.
+	TEST(GameBatchTest, LanesPlayAsAnalyticGames) {
+		constexpr size_t Count = 203;
+		constexpr uint32_t Seed = 7, TickCount = 60 * 30;
+
+		GameBatch batch(Count, Seed);
+
+		vector<unique_ptr<AnalyticGame>> games;
+		for (size_t i = 0; i < Count; i++) games.emplace_back(make_unique<AnalyticGame>(12 * 16 / 9.0f, static_cast<uint32_t>(Seed + i)));
+
+		const Random random(Seed);
+		vector<uint8_t> actions(Count);
+		for (uint32_t tick = 0; tick < TickCount; tick++) {
+			for (size_t i = 0; i < Count; i++) {
+				const auto flyUpProbability = 0.01f + 0.24f * static_cast<float>(i) / (Count - 1);
+				actions[i] = random.FloatAt(static_cast<uint64_t>(tick) * Count + i) < flyUpProbability;
+
+				if (actions[i]) games[i]->FlyUp();
+				games[i]->Update(StepSeconds);
+			}
+
+			batch.Step(actions.data(), StepSeconds);
+
+			for (size_t i = 0; i < Count; i++) {
+				const auto& game = *games[i];
+				ASSERT_EQ(batch.GetState(i), game.GetState()) << "Lane " << i << ", tick " << tick;
+				ASSERT_EQ(batch.GetScore(i), game.GetScore()) << "Lane " << i << ", tick " << tick;
+				if (game.GetState() != AnalyticGame::State::Over) {
+					ASSERT_NEAR(batch.GetPawnPosition(i).y, game.GetPawnPosition().y, 1e-3f) << "Lane " << i << ", tick " << tick;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,73 @@
+//
+// RenderResourceCacheTests.cpp - Checks what the render resource cache creates and keeps from frame to frame
+//
+
+#include "RenderResourceCache.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	// Stands in for Direct2D and DirectWrite and counts what the cache asks it to create.
+	struct CountingResources {
+		using TextFormat = uint32_t;
+		using SolidBrush = uint32_t;
+		using TextLayout = uint32_t;
+
+		uint32_t CreatedCount{};
+
+		TextFormat CreateTextFormat(string_view, float) { return ++CreatedCount; }
+		SolidBrush CreateSolidBrush(uint32_t) { return ++CreatedCount; }
+		TextLayout CreateTextLayout(string_view, const TextFormat&, float, float) { return ++CreatedCount; }
+	};
+
+	// The text RenderGame draws for a game that is over, with the given score.
+	void RenderFrame(RenderResourceCache<CountingResources>& cache, string_view score) {
+		constexpr auto FontFamily = "Comic Sans MS";
+		constexpr float Height = 720;
+		const auto RenderText = [&](string_view text, float fontSize, uint32_t rgb) {
+			cache.GetTextLayout(text, FontFamily, fontSize * Height, Height * 16 / 9, fontSize * Height);
+			cache.GetSolidBrush(rgb);
+		};
+		RenderText(score, 0.08f, 0x0063b1);
+		RenderText("Game Over", 0.1f, 0xea005e);
+		RenderText("Press any key to restart.", 0.04f, 0x008080);
+		cache.EndFrame();
+	}
+
+	TEST(RenderResourceCacheTest, SteadyFramesCreateNothing) {
+		RenderResourceCache<CountingResources> cache;
+		RenderFrame(cache, "42");
+		const auto createdCount = cache.GetBackend().CreatedCount;
+
+		for (auto i = 0; i < 10; i++) RenderFrame(cache, "42");
+
+		EXPECT_EQ(cache.GetBackend().CreatedCount, createdCount);
+	}
+
+	// A new score needs its layout and nothing else, and the old score's layout is evicted at the end of the frame.
+	TEST(RenderResourceCacheTest, NewScoreCreatesOnlyItsLayout) {
+		RenderResourceCache<CountingResources> cache;
+		RenderFrame(cache, "42");
+		const auto createdCount = cache.GetBackend().CreatedCount;
+		const auto size = cache.GetSize();
+
+		RenderFrame(cache, "43");
+
+		EXPECT_EQ(cache.GetBackend().CreatedCount - createdCount, 1u);
+		EXPECT_EQ(cache.GetSize(), size);
+		EXPECT_EQ(cache.GetStatistics().Evictions, 1u);
+	}
+
+	TEST(RenderResourceCacheTest, InvalidateRecreatesEverything) {
+		RenderResourceCache<CountingResources> cache;
+		RenderFrame(cache, "42");
+		const auto createdCount = cache.GetBackend().CreatedCount;
+
+		cache.Invalidate();
+		RenderFrame(cache, "42");
+
+		EXPECT_EQ(cache.GetBackend().CreatedCount, createdCount * 2);
+	}
+}
@@ -0,0 +1,65 @@
+//
+// ReplayTests.cpp - Checks that seeking a replay lands on the recorded game and that corrupt keyframes are refused
+//
+
+#include "Replay.h"
+
+#include "Policies.h"
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+
+using namespace std;
+
+namespace {
+	template <typename TGame>
+	class ReplayTest : public testing::Test {};
+
+	using Games = testing::Types<Game, AnalyticGame>;
+	TYPED_TEST_SUITE(ReplayTest, Games);
+
+	template <typename TGame>
+	string RecordReplay(const InputTrace& trace) {
+		ostringstream stream;
+		WriteReplay<TGame>(stream, trace);
+		return std::move(stream).str();
+	}
+
+	span<const byte> GetBytes(const string& replay) { return as_bytes(span(replay)); }
+
+	// Seeking to any tick, from keyframes before and after it, gives the game that playing the trace gives.
+	TYPED_TEST(ReplayTest, SeekMatchesPlayback) {
+		const auto trace = RecordTrace<TypeParam>(AutopilotPolicy(), 60 * 20);
+		const auto replay = RecordReplay<TypeParam>(trace);
+		const ReplayReader reader(GetBytes(replay));
+
+		TypeParam game(trace.WorldWidth, trace.Seed), seeked(trace.WorldWidth, trace.Seed);
+		for (uint32_t tick = 0; tick <= trace.Presses.size(); tick++) {
+			if (tick % 47 == 0) {
+				reader.Seek(seeked, tick);
+				EXPECT_EQ(seeked.GetStateHash(), game.GetStateHash()) << "Seeked to tick " << tick;
+			}
+
+			if (tick == trace.Presses.size()) break;
+
+			if (trace.Presses[tick]) {
+				if (game.GetState() == TypeParam::State::Over) game.Reset();
+				else game.FlyUp();
+			}
+			game.Update(trace.StepSeconds);
+		}
+	}
+
+	// A keyframe with an impossible barrier count throws instead of being restored.
+	TYPED_TEST(ReplayTest, CorruptKeyframeThrows) {
+		const auto trace = RecordTrace<TypeParam>(AutopilotPolicy(), 60 * 2);
+		auto replay = RecordReplay<TypeParam>(trace);
+
+		const auto offset = ReplayReader(GetBytes(replay)).GetKeyframe(0).Offset;
+		fill_n(replay.begin() + static_cast<ptrdiff_t>(offset), sizeof(typename TypeParam::SavedState), '\xff');
+
+		TypeParam game(trace.WorldWidth, trace.Seed);
+		EXPECT_THROW(ReplayReader(GetBytes(replay)).Seek(game, 0), runtime_error);
+	}
+}
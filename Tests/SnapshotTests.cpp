@@ -0,0 +1,54 @@
+//
+// SnapshotTests.cpp - Checks that a restored game plays on exactly as the one it was saved from
+//
+
+#include "Determinism.h"
+
+#include "Policies.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	template <typename TGame>
+	class SnapshotTest : public testing::Test {};
+
+	using Games = testing::Types<Game, AnalyticGame>;
+	TYPED_TEST_SUITE(SnapshotTest, Games);
+
+	// A game restored from a Running tick of the autopilot's play, into a game that was at another tick, plays the
+	// next two seconds as the original did. Over games are left out: they rest on the ground, and Box2D contact
+	// impulses are not saved.
+	TYPED_TEST(SnapshotTest, RestoredGamePlaysOn) {
+		const auto trace = RecordTrace<TypeParam>(AutopilotPolicy(), 60 * 60);
+		const auto tickCount = static_cast<uint32_t>(trace.Presses.size());
+
+		TypeParam game(trace.WorldWidth, trace.Seed);
+		for (uint32_t tick = 0; tick < tickCount; tick++) {
+			if (game.GetState() == TypeParam::State::Running && tick % 53 == 0) {
+				const auto divergence = VerifyRestore<TypeParam>(trace, tick, (tick + 37) % tickCount, 120);
+				EXPECT_FALSE(divergence) << "Restored at tick " << tick << ", diverged at tick " << divergence->Tick;
+			}
+
+			if (trace.Presses[tick]) {
+				if (game.GetState() == TypeParam::State::Over) game.Reset();
+				else game.FlyUp();
+			}
+			game.Update(trace.StepSeconds);
+		}
+	}
+
+	// Every world the physics has room for can be saved and restored.
+	TYPED_TEST(SnapshotTest, RestoresTheWidestWorld) {
+		auto worldWidth = 12.0f;
+		while (TypeParam::GetRequiredBarrierCapacity(worldWidth + 1) <= TypeParam::Physics::MaxBarrierCount) worldWidth++;
+
+		InputTrace course;
+		course.WorldWidth = worldWidth;
+		const auto trace = RecordTrace<TypeParam>(AutopilotPolicy(), 60 * 10, course);
+
+		const auto divergence = VerifyRestore<TypeParam>(trace, 60 * 5, 60 * 2, 120);
+		EXPECT_FALSE(divergence) << "World " << worldWidth << " units wide diverged at tick " << divergence->Tick;
+	}
+}
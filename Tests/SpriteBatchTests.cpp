@@ -0,0 +1,47 @@
+//
+// SpriteBatchTests.cpp - Checks that sprite batching keeps draw submission flat as the world widens
+//
+
+#include "Game.h"
+
+#include "Policies.h"
+
+#include "RecordingRenderer.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+
+namespace {
+	// What RenderGame submits for a frame after ten seconds of the autopilot's play in a world that wide.
+	RecordingRenderer::Counts RenderAutopilotFrame(float worldWidth) {
+		constexpr AutopilotPolicy Autopilot;
+
+		AnalyticGame game(worldWidth, 0);
+		game.FlyUp();
+		for (uint32_t i = 0; i < 600; i++) {
+			if (Autopilot(game)) game.FlyUp();
+			game.Update(1 / 60.0f);
+		}
+
+		RecordingRenderer renderer({ worldWidth * 100, 1200 });
+		RenderSnapshot snapshot;
+		SpriteBatch spriteBatch;
+		snapshot.Capture(game);
+		renderer.BeginFrame();
+		RenderGame(renderer, snapshot, GetWorldTransform(renderer.GetSize(), snapshot.WorldSize), spriteBatch);
+		renderer.EndFrame();
+		return renderer.GetFrameCounts();
+	}
+
+	// However many barriers are visible, the draws besides text are as many as in the narrowest world.
+	TEST(SpriteBatchTest, DrawCallsStayFlatAsTheWorldWidens) {
+		const auto narrowest = RenderAutopilotFrame(16);
+
+		for (const auto worldWidth : { 32.0f, 64.0f }) {
+			const auto counts = RenderAutopilotFrame(worldWidth);
+			EXPECT_EQ(counts.DrawCalls - counts.Texts, narrowest.DrawCalls - narrowest.Texts) << "World " << worldWidth << " units wide";
+			EXPECT_GT(counts.Sprites, narrowest.Sprites) << "World " << worldWidth << " units wide";
+		}
+	}
+}
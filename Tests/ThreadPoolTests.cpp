@@ -0,0 +1,32 @@
+//
+// ThreadPoolTests.cpp - Checks that a thread pool runs every job of a batch exactly once
+//
+
+#include "ThreadPool.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace std;
+
+namespace {
+	// Batches whose last jobs run far longer than the rest, so that most workers run dry while a few still work, and
+	// the next batch has to wake them again.
+	TEST(ThreadPoolTest, RunsEveryJobOnceAcrossUnevenBatches) {
+		ThreadPool threadPool(4);
+
+		constexpr uint64_t JobCount = 1000;
+		vector<atomic<uint32_t>> runCounts(JobCount);
+		for (auto batch = 0; batch < 20; batch++) {
+			threadPool.Run(JobCount, [&](uint64_t index, uint32_t workerIndex) {
+				EXPECT_LT(workerIndex, threadPool.GetThreadCount());
+
+				if (index >= JobCount - 4) this_thread::sleep_for(chrono::milliseconds(2));
+				runCounts[index].fetch_add(1, memory_order_relaxed);
+			});
+
+			for (uint64_t i = 0; i < JobCount; i++) ASSERT_EQ(runCounts[i].exchange(0), 1u) << "Job " << i << " in batch " << batch;
+		}
+	}
+}
@@ -0,0 +1,55 @@
+//
+// TraceTests.cpp - Checks that a trace buffer can be read while its thread keeps writing
+//
+
+#include "Trace.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace std;
+
+namespace {
+	// Every event copied while the owner overwrites the ring is one it wrote whole, and they come out in order.
+	TEST(TraceTest, ReadsWhileWriting) {
+		constexpr const char* Names[]{ "Even", "Odd" };
+
+		const auto buffer = make_unique<Trace::Buffer>(7);
+
+		// The writer is stopped when the test returns, even on a failed assertion.
+		atomic<int64_t> writtenCount{};
+		jthread writer([&](stop_token stopToken) {
+			for (int64_t i = 0; !stopToken.stop_requested(); i++) {
+				buffer->Write(Names[i % 2], i, i * 3);
+				writtenCount.store(i + 1, memory_order_relaxed);
+			}
+		});
+
+		// Reading starts once the ring has wrapped, so that every read races with overwrites.
+		while (writtenCount.load(memory_order_relaxed) <= static_cast<int64_t>(Trace::Buffer::Capacity)) this_thread::yield();
+
+		vector<Trace::Event> events;
+		for (auto read = 0; read < 200; read++) {
+			events.clear();
+			buffer->Read(events);
+
+			for (size_t i = 0; i < events.size(); i++) {
+				const auto& event = events[i];
+				ASSERT_EQ(event.Name, Names[event.BeginNanoseconds % 2]);
+				ASSERT_EQ(event.ThreadIndex, 7u);
+				ASSERT_EQ(event.EndNanoseconds, event.BeginNanoseconds * 3);
+				if (i) ASSERT_LT(events[i - 1].BeginNanoseconds, event.BeginNanoseconds);
+			}
+		}
+
+		writer.request_stop();
+		writer.join();
+
+		// Once the owner stops, the whole ring is read back.
+		events.clear();
+		buffer->Read(events);
+		ASSERT_EQ(events.size(), Trace::Buffer::Capacity);
+		for (size_t i = 1; i < events.size(); i++) EXPECT_EQ(events[i].BeginNanoseconds, events[i - 1].BeginNanoseconds + 1);
+	}
+}